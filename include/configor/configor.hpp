@@ -20,6 +20,8 @@
 
 #pragma once
 #include "details/conversion.hpp"
+#include "details/insitu_string.hpp"
+#include "details/interned_string.hpp"
 #include "details/parser.hpp"
 #include "details/serializer.hpp"
 #include "details/wrapper.hpp"
@@ -63,6 +65,20 @@ struct wvalue_tplargs : value_tplargs
     using char_type = wchar_t;
 };
 
+// strings may refer to the parsed buffer, see basic_insitu_string
+struct insitu_value_tplargs : value_tplargs
+{
+    template <class _CharTy, class... _Args>
+    using string_type = basic_insitu_string<_CharTy, _Args...>;
+};
+
+// keys may share the characters interned by the parser, see basic_interned_string
+struct interned_value_tplargs : value_tplargs
+{
+    template <class _CharTy, class... _Args>
+    using string_type = basic_interned_string<_CharTy, _Args...>;
+};
+
 using value  = basic_value<value_tplargs>;
 using wvalue = basic_value<wvalue_tplargs>;
 
@@ -22,14 +22,18 @@
 #include "stream.hpp"
 #include "value.hpp"
 
+#include <algorithm>      // std::lower_bound, std::stable_sort
 #include <array>          // std::array
+#include <cstdint>        // std::uint64_t
 #include <deque>          // std::deque
 #include <forward_list>   // std::forward_list
+#include <limits>         // std::numeric_limits
 #include <list>           // std::list
 #include <map>            // std::map
 #include <memory>         // std::unique_ptr, std::shared_ptr, std::make_shared
 #include <queue>          // std::queue
 #include <set>            // std::set
+#include <stdexcept>      // std::length_error
 #include <type_traits>    // std::enable_if, std::is_same, std::false_type, std::true_type, std::is_void
 #include <unordered_map>  // std::unordered_map
 #include <unordered_set>  // std::unordered_set
@@ -535,6 +539,128 @@ public:
     }
 };
 
+namespace detail
+{
+
+//
+// field table
+// CONFIGOR_BIND also generates configor_visit_fields(const value_type*, custom_type&, visitor),
+// which calls visitor(name, field, required) for each bound field, in order,
+// required is std::true_type or std::false_type
+//
+
+struct field_visitor_probe
+{
+    template <typename _CharTy, typename _Ty>
+    void operator()(const _CharTy*, _Ty&, bool)
+    {
+    }
+};
+
+template <typename _ValTy, typename _Ty>
+using visit_fields_fn = decltype(configor_visit_fields(std::declval<const _ValTy*>(), std::declval<_Ty&>(),
+                                                       std::declval<field_visitor_probe&>()));
+
+template <typename _ValTy, typename _Ty>
+using has_field_table = exact_detect<void, visit_fields_fn, _ValTy, _Ty>;
+
+// the fields of a bound type are the bits of a 64-bit mask,
+// which also bounds the arrays of fields of the readers and serializers
+constexpr std::size_t max_bound_fields = 64;
+static_assert(max_bound_fields <= std::numeric_limits<std::uint64_t>::digits, "the fields must fit in a 64-bit mask");
+
+template <typename _ValTy, typename _Ty>
+class field_table
+{
+public:
+    using value_type  = _ValTy;
+    using string_type = typename value_type::string_type;
+
+    static const field_table& get(const _Ty& v)
+    {
+        static const field_table table(v);
+        return table;
+    }
+
+    // returns size() if the key is not a field
+    std::size_t find(const string_type& key) const
+    {
+        const auto iter = std::lower_bound(sorted_.begin(), sorted_.end(), key,
+                                           [&](std::size_t i, const string_type& k) { return names_[i] < k; });
+        if (iter != sorted_.end() && names_[*iter] == key)
+            return *iter;
+        return names_.size();
+    }
+
+    inline std::size_t size() const
+    {
+        return names_.size();
+    }
+
+    inline const string_type& name(std::size_t i) const
+    {
+        return names_[i];
+    }
+
+    // the bit i is set if the field i is required
+    inline std::uint64_t required() const
+    {
+        return required_;
+    }
+
+    // the indices of the fields in the iteration order of an object with their names
+    inline const std::vector<std::size_t>& object_order() const
+    {
+        return object_order_;
+    }
+
+private:
+    explicit field_table(const _Ty& v)
+        : names_()
+        , required_(0)
+        , object_order_()
+        , sorted_()
+    {
+        // the visitor only reads the names
+        collector c{ *this };
+        configor_visit_fields(static_cast<const value_type*>(nullptr), const_cast<_Ty&>(v), c);
+        if (names_.size() > max_bound_fields)
+            throw std::length_error("too many fields of a bound type");
+
+        typename value_type::object_type object;
+        for (std::size_t i = 0; i < names_.size(); ++i)
+            object[names_[i]] = static_cast<typename value_type::integer_type>(i);
+        for (const auto& pair : object)
+            object_order_.push_back(static_cast<std::size_t>(pair.second.data().integer));
+
+        // the first of duplicated names is found, like a linear search
+        for (std::size_t i = 0; i < names_.size(); ++i)
+            sorted_.push_back(i);
+        std::stable_sort(sorted_.begin(), sorted_.end(),
+                         [&](std::size_t lhs, std::size_t rhs) { return names_[lhs] < names_[rhs]; });
+    }
+
+    struct collector
+    {
+        field_table& table;
+
+        template <typename _CharTy, typename _FieldTy>
+        void operator()(const _CharTy* name, _FieldTy&, bool required)
+        {
+            if (required)
+                table.required_ |= std::uint64_t(1) << table.names_.size();
+            table.names_.emplace_back(name, name + std::char_traits<_CharTy>::length(name));
+        }
+    };
+
+    std::vector<string_type> names_;
+    std::uint64_t            required_;
+    std::vector<std::size_t> object_order_;
+    std::vector<std::size_t> sorted_;
+};
+
+}  // namespace detail
+
 }  // namespace configor
 
 // __CONFIGOR_EXPAND is a solution for this question:
@@ -797,6 +923,9 @@ public:
         __CONFIGOR_FROM_CONF_REQUIRED(field, name) \
     }
 
+#define __CONFIGOR_VISIT_FIELD_REQUIRED(field, name) visitor(name, v.field, std::true_type{});
+#define __CONFIGOR_VISIT_FIELD_OPTIONAL(field, name) visitor(name, v.field, std::false_type{});
+
 // REQUIRED/OPTIONAL
 #define __CONFIGOR_TO_CONF_REQUIRED1(field) __CONFIGOR_TO_CONF_REQUIRED(field, #field)
 #define __CONFIGOR_TO_CONF_REQUIRED2(field, name) __CONFIGOR_TO_CONF_REQUIRED(field, name)
@@ -806,6 +935,10 @@ public:
 #define __CONFIGOR_FROM_CONF_REQUIRED2(field, name) __CONFIGOR_FROM_CONF_REQUIRED(field, name)
 #define __CONFIGOR_FROM_CONF_OPTIONAL1(field) __CONFIGOR_FROM_CONF_OPTIONAL(field, #field)
 #define __CONFIGOR_FROM_CONF_OPTIONAL2(field, name) __CONFIGOR_FROM_CONF_OPTIONAL(field, name)
+#define __CONFIGOR_VISIT_FIELD_REQUIRED1(field) __CONFIGOR_VISIT_FIELD_REQUIRED(field, #field)
+#define __CONFIGOR_VISIT_FIELD_REQUIRED2(field, name) __CONFIGOR_VISIT_FIELD_REQUIRED(field, name)
+#define __CONFIGOR_VISIT_FIELD_OPTIONAL1(field) __CONFIGOR_VISIT_FIELD_OPTIONAL(field, #field)
+#define __CONFIGOR_VISIT_FIELD_OPTIONAL2(field, name) __CONFIGOR_VISIT_FIELD_OPTIONAL(field, name)
 
 #define __CONFIGOR_TO_CONF_CALL_OVERLOADREQUIRED(...) \
     __CONFIGOR_EXPAND(__CONFIGOR_CALL_OVERLOAD(__CONFIGOR_TO_CONF_REQUIRED, __VA_ARGS__))
@@ -815,6 +948,10 @@ public:
     __CONFIGOR_EXPAND(__CONFIGOR_CALL_OVERLOAD(__CONFIGOR_FROM_CONF_REQUIRED, __VA_ARGS__))
 #define __CONFIGOR_FROM_CONF_CALL_OVERLOADOPTIONAL(...) \
     __CONFIGOR_EXPAND(__CONFIGOR_CALL_OVERLOAD(__CONFIGOR_FROM_CONF_OPTIONAL, __VA_ARGS__))
+#define __CONFIGOR_VISIT_FIELD_CALL_OVERLOADREQUIRED(...) \
+    __CONFIGOR_EXPAND(__CONFIGOR_CALL_OVERLOAD(__CONFIGOR_VISIT_FIELD_REQUIRED, __VA_ARGS__))
+#define __CONFIGOR_VISIT_FIELD_CALL_OVERLOADOPTIONAL(...) \
+    __CONFIGOR_EXPAND(__CONFIGOR_CALL_OVERLOAD(__CONFIGOR_VISIT_FIELD_OPTIONAL, __VA_ARGS__))
 
 // Bind custom type to configor value
 // e.g.
@@ -829,4 +966,10 @@ public:
     {                                                                                                                 \
         __CONFIGOR_EXPAND(                                                                                            \
             __CONFIGOR_PASTE(__CONFIGOR_COMBINE_PASTE1, __CONFIGOR_FROM_CONF_CALL_OVERLOAD, __VA_ARGS__))             \
+    }                                                                                                                 \
+    template <typename _VisitorTy>                                                                                    \
+    friend void configor_visit_fields(const value_type*, custom_type& v, _VisitorTy& visitor)                         \
+    {                                                                                                                 \
+        __CONFIGOR_EXPAND(                                                                                            \
+            __CONFIGOR_PASTE(__CONFIGOR_COMBINE_PASTE1, __CONFIGOR_VISIT_FIELD_CALL_OVERLOAD, __VA_ARGS__))           \
     }
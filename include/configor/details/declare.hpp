@@ -103,6 +103,68 @@ struct priority<0>
 {
 };
 
+// option_tag
+// the base of every option given as a type, which tells them apart from character types
+
+struct option_tag
+{
+};
+
+template <typename _Ty>
+struct is_option : std::is_base_of<option_tag, _Ty>
+{
+};
+
+// option_list
+// applies options given as types, each option changes the traits of the parser or serializer with
+// parser_traits<> or serializer_traits<>, then sets the other settings with apply_parser() or apply_serializer()
+
+template <typename... _Opts>
+struct option_list
+{
+    template <typename _TraitsTy>
+    using parser_traits = _TraitsTy;
+
+    template <typename _TraitsTy>
+    using serializer_traits = _TraitsTy;
+
+    template <typename _ParserTy>
+    static void apply_parser(_ParserTy&)
+    {
+    }
+
+    template <typename _SerializerTy>
+    static void apply_serializer(_SerializerTy&)
+    {
+    }
+};
+
+template <typename _Opt, typename... _Opts>
+struct option_list<_Opt, _Opts...>
+{
+    template <typename _TraitsTy>
+    using parser_traits =
+        typename option_list<_Opts...>::template parser_traits<typename _Opt::template parser_traits<_TraitsTy>>;
+
+    template <typename _TraitsTy>
+    using serializer_traits = typename option_list<_Opts...>::template serializer_traits<
+        typename _Opt::template serializer_traits<_TraitsTy>>;
+
+    template <typename _ParserTy>
+    static void apply_parser(_ParserTy& p)
+    {
+        _Opt::apply_parser(p);
+        option_list<_Opts...>::apply_parser(p);
+    }
+
+    template <typename _SerializerTy>
+    static void apply_serializer(_SerializerTy& s)
+    {
+        _Opt::apply_serializer(s);
+        option_list<_Opts...>::apply_serializer(s);
+    }
+};
+
 // remove_cvref
 
 template <typename _Ty>
@@ -19,11 +19,16 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "declare.hpp"
+
 #include <array>        // std::array
+#include <cstddef>      // std::size_t
 #include <cstdint>      // uint32_t, uint8_t
 #include <istream>      // std::basic_istream
 #include <ostream>      // std::basic_ostream
-#include <type_traits>  // std::char_traits
+#include <streambuf>    // std::basic_streambuf
+#include <type_traits>  // std::char_traits, std::true_type, std::false_type
+#include <utility>      // std::declval
 
 namespace configor
 {
@@ -78,6 +83,18 @@ using encoder = void (*)(std::basic_ostream<_CharTy>&, uint32_t);
 template <typename _CharTy>
 using decoder = bool (*)(std::basic_istream<_CharTy>&, uint32_t&);
 
+// decode one codepoint from a non-empty range [first, last) and advance first
+// return false if the range does not start with a valid sequence
+template <typename _CharTy>
+using buffer_decoder = bool (*)(const _CharTy*&, const _CharTy*, uint32_t&);
+
+// encode one codepoint into at most `max_encoded_length` characters
+// return the end of written characters, or nullptr if the codepoint cannot be encoded
+template <typename _CharTy>
+using buffer_encoder = _CharTy* (*)(_CharTy*, uint32_t);
+
+constexpr std::size_t max_encoded_length = 4;
+
 template <typename _CharTy>
 class ignore
 {
@@ -92,11 +109,23 @@ public:
         os.put(static_cast<char_type>(codepoint));
     }
 
+    static char_type* encode(char_type* out, uint32_t codepoint)
+    {
+        *out++ = static_cast<char_type>(codepoint);
+        return out;
+    }
+
     static bool decode(istream_type& is, uint32_t& codepoint)
     {
         codepoint = static_cast<uint32_t>(static_cast<char_type>(is.get()));
         return !is.eof();
     }
+
+    static bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint)
+    {
+        codepoint = static_cast<uint32_t>(*first++);
+        return true;
+    }
 };
 
 template <typename _CharTy>
@@ -147,6 +176,41 @@ public:
         }
     }
 
+    static char_type* encode(char_type* out, uint32_t codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            // 0xxxxxxx
+            *out++ = static_cast<char_type>(codepoint);
+        }
+        else if (codepoint <= 0x7FF)
+        {
+            // 110xxxxx 10xxxxxx
+            *out++ = static_cast<char_type>(0xC0 | (codepoint >> 6));
+            *out++ = static_cast<char_type>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint <= 0xFFFF)
+        {
+            // 1110xxxx 10xxxxxx 10xxxxxx
+            *out++ = static_cast<char_type>(0xE0 | (codepoint >> 12));
+            *out++ = static_cast<char_type>(0x80 | ((codepoint >> 6) & 0x3F));
+            *out++ = static_cast<char_type>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint <= 0x10FFFF)
+        {
+            // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+            *out++ = static_cast<char_type>(0xF0 | (codepoint >> 18));
+            *out++ = static_cast<char_type>(0x80 | ((codepoint >> 12) & 0x3F));
+            *out++ = static_cast<char_type>(0x80 | ((codepoint >> 6) & 0x3F));
+            *out++ = static_cast<char_type>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            return nullptr;
+        }
+        return out;
+    }
+
     static bool decode(istream_type& is, uint32_t& codepoint)
     {
         // Unicode              UTF-8
@@ -154,20 +218,8 @@ public:
         // U+0080...U+07FF      110xxxxx 10xxxxxx
         // U+0800...U+FFFF      1110xxxx 10xxxxxx 10xxxxxx
         // U+10000...U+10FFFF   11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        static const std::array<std::uint8_t, 256> utf8_extra_bytes = {
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-            2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5,
-        };
-
-        static const std::array<std::uint32_t, 6> utf8_offsets = {
-            0x00000000, 0x00003080, 0x000E2080, 0x03C82080, 0xFA082080, 0x82082080,
-        };
+        const auto& utf8_extra_bytes = extra_bytes();
+        const auto& utf8_offsets     = offsets();
 
         // peek one byte and check eof
         const auto first_byte = static_cast<uint8_t>(is.peek());
@@ -206,6 +258,61 @@ public:
         }
         return true;
     }
+
+    static bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint)
+    {
+        const auto first_byte = static_cast<uint8_t>(*first);
+        if (first_byte < 0x80)
+        {
+            // ASCII
+            codepoint = first_byte;
+            ++first;
+            return true;
+        }
+
+        const auto extra_bytes_to_read = extra_bytes()[first_byte];
+        if (last - first <= extra_bytes_to_read)
+        {
+            // truncated sequence
+            codepoint = first_byte;
+            first     = last;
+            return false;
+        }
+
+        codepoint = 0;
+        for (uint8_t i = 0; i < extra_bytes_to_read; ++i)
+        {
+            codepoint += static_cast<uint32_t>(static_cast<uint8_t>(*first++));
+            codepoint <<= 6;
+        }
+        codepoint += static_cast<uint32_t>(static_cast<uint8_t>(*first++));
+        codepoint -= offsets()[extra_bytes_to_read];
+        return codepoint <= 0x10FFFF;
+    }
+
+private:
+    static const std::array<std::uint8_t, 256>& extra_bytes()
+    {
+        static const std::array<std::uint8_t, 256> utf8_extra_bytes = {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+            2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5,
+        };
+        return utf8_extra_bytes;
+    }
+
+    static const std::array<std::uint32_t, 6>& offsets()
+    {
+        static const std::array<std::uint32_t, 6> utf8_offsets = {
+            0x00000000, 0x00003080, 0x000E2080, 0x03C82080, 0xFA082080, 0x82082080,
+        };
+        return utf8_offsets;
+    }
 };
 
 template <typename _CharTy>
@@ -238,6 +345,26 @@ public:
         }
     }
 
+    static char_type* encode(char_type* out, uint32_t codepoint)
+    {
+        if (codepoint <= 0xFFFF)
+        {
+            *out++ = traits_type::to_char_type(static_cast<typename traits_type::int_type>(codepoint));
+        }
+        else if (codepoint <= 0x10FFFF)
+        {
+            uint32_t lead_surrogate = 0, trail_surrogate = 0;
+            unicode::encode_surrogates(codepoint, lead_surrogate, trail_surrogate);
+            *out++ = traits_type::to_char_type(static_cast<typename traits_type::int_type>(lead_surrogate));
+            *out++ = traits_type::to_char_type(static_cast<typename traits_type::int_type>(trail_surrogate));
+        }
+        else
+        {
+            return nullptr;
+        }
+        return out;
+    }
+
     static bool decode(istream_type& is, uint32_t& codepoint)
     {
         codepoint = static_cast<uint32_t>(static_cast<uint16_t>(is.get()));
@@ -266,6 +393,26 @@ public:
         }
         return true;
     }
+
+    static bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint)
+    {
+        codepoint = static_cast<uint32_t>(static_cast<uint16_t>(*first++));
+
+        if (unicode::is_lead_surrogate(codepoint))
+        {
+            if (first == last)
+                return false;
+
+            uint32_t lead_surrogate  = codepoint;
+            uint32_t trail_surrogate = static_cast<uint32_t>(static_cast<uint16_t>(*first++));
+
+            if (!unicode::is_trail_surrogate(trail_surrogate))
+                return false;
+
+            codepoint = unicode::decode_surrogates(lead_surrogate, trail_surrogate);
+        }
+        return codepoint <= 0x10FFFF;
+    }
 };
 
 template <typename _CharTy>
@@ -288,6 +435,16 @@ public:
         os.put(traits_type::to_char_type(static_cast<typename traits_type::int_type>(codepoint)));
     }
 
+    static char_type* encode(char_type* out, uint32_t codepoint)
+    {
+        if (codepoint > 0x10FFFF)
+        {
+            return nullptr;
+        }
+        *out++ = traits_type::to_char_type(static_cast<typename traits_type::int_type>(codepoint));
+        return out;
+    }
+
     static bool decode(istream_type& is, uint32_t& codepoint)
     {
         codepoint = static_cast<uint32_t>(is.get());
@@ -301,6 +458,12 @@ public:
         }
         return true;
     }
+
+    static bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint)
+    {
+        codepoint = static_cast<uint32_t>(*first++);
+        return codepoint <= 0x10FFFF;
+    }
 };
 
 template <typename _CharTy>
@@ -317,11 +480,21 @@ public:
         encode(os, codepoint, std::integral_constant<int, sizeof(char_type)>());
     }
 
+    static inline char_type* encode(char_type* out, uint32_t codepoint)
+    {
+        return encode(out, codepoint, std::integral_constant<int, sizeof(char_type)>());
+    }
+
     static inline bool decode(istream_type& is, uint32_t& codepoint)
     {
         return decode(is, codepoint, std::integral_constant<int, sizeof(char_type)>());
     }
 
+    static inline bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint)
+    {
+        return decode(first, last, codepoint, std::integral_constant<int, sizeof(char_type)>());
+    }
+
 private:
     static inline void encode(ostream_type& os, uint32_t codepoint, std::integral_constant<int, 1>)
     {
@@ -338,6 +511,21 @@ private:
         utf32<char_type>::encode(os, codepoint);
     }
 
+    static inline char_type* encode(char_type* out, uint32_t codepoint, std::integral_constant<int, 1>)
+    {
+        return utf8<char_type>::encode(out, codepoint);
+    }
+
+    static inline char_type* encode(char_type* out, uint32_t codepoint, std::integral_constant<int, 2>)
+    {
+        return utf16<char_type>::encode(out, codepoint);
+    }
+
+    static inline char_type* encode(char_type* out, uint32_t codepoint, std::integral_constant<int, 4>)
+    {
+        return utf32<char_type>::encode(out, codepoint);
+    }
+
     static inline bool decode(istream_type& is, uint32_t& codepoint, std::integral_constant<int, 1>)
     {
         return utf8<char_type>::decode(is, codepoint);
@@ -352,6 +540,24 @@ private:
     {
         return utf32<char_type>::decode(is, codepoint);
     }
+
+    static inline bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint,
+                              std::integral_constant<int, 1>)
+    {
+        return utf8<char_type>::decode(first, last, codepoint);
+    }
+
+    static inline bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint,
+                              std::integral_constant<int, 2>)
+    {
+        return utf16<char_type>::decode(first, last, codepoint);
+    }
+
+    static inline bool decode(const char_type*& first, const char_type* last, uint32_t& codepoint,
+                              std::integral_constant<int, 4>)
+    {
+        return utf32<char_type>::decode(first, last, codepoint);
+    }
 };
 
 //
@@ -383,6 +589,87 @@ struct is_unicode_encoding<auto_utf<_CharTy>> : std::true_type
 {
 };
 
+// encodings which read and write UTF-8 in single byte characters
+template <typename _Encoding>
+struct is_utf8_encoding : std::false_type
+{
+};
+
+template <typename _CharTy>
+struct is_utf8_encoding<utf8<_CharTy>> : std::integral_constant<bool, sizeof(_CharTy) == 1>
+{
+};
+
+template <typename _CharTy>
+struct is_utf8_encoding<auto_utf<_CharTy>> : std::integral_constant<bool, sizeof(_CharTy) == 1>
+{
+};
+
+namespace buffer_codec
+{
+template <typename _Encoding, typename _CharTy>
+using decode_fn = decltype(_Encoding::decode(std::declval<const _CharTy*&>(), std::declval<const _CharTy*>(),
+                                             std::declval<uint32_t&>()));
+
+template <typename _Encoding, typename _CharTy>
+using encode_fn = decltype(_Encoding::encode(std::declval<_CharTy*>(), std::declval<uint32_t>()));
+
+template <typename _Encoding, typename _CharTy>
+_CharTy* encode_through_stream(_CharTy* out, uint32_t codepoint)
+{
+    class streambuf : public std::basic_streambuf<_CharTy>
+    {
+    public:
+        explicit streambuf(_CharTy* out)
+        {
+            this->setp(out, out + max_encoded_length);
+        }
+
+        _CharTy* end() const
+        {
+            return this->pptr();
+        }
+    };
+
+    streambuf                   buf{ out };
+    std::basic_ostream<_CharTy> os{ &buf };
+    _Encoding::encode(os, codepoint);
+    return os.good() ? buf.end() : nullptr;
+}
+
+template <typename _Encoding, typename _CharTy>
+inline buffer_encoder<_CharTy> get_encoder(std::true_type)
+{
+    return _Encoding::encode;
+}
+
+template <typename _Encoding, typename _CharTy>
+inline buffer_encoder<_CharTy> get_encoder(std::false_type)
+{
+    return encode_through_stream<_Encoding, _CharTy>;
+}
+}  // namespace buffer_codec
+
+template <typename _Encoding, typename _CharTy>
+struct is_buffer_decodable
+    : configor::detail::exact_detect<bool, buffer_codec::decode_fn, _Encoding, _CharTy>
+{
+};
+
+template <typename _Encoding, typename _CharTy>
+struct is_buffer_encodable
+    : configor::detail::exact_detect<_CharTy*, buffer_codec::encode_fn, _Encoding, _CharTy>
+{
+};
+
+// returns an encoder which writes into a buffer
+// encodings without such an encoder are adapted through a stream
+template <template <class> class _Encoding, typename _CharTy>
+inline buffer_encoder<_CharTy> get_buffer_encoder()
+{
+    return buffer_codec::get_encoder<_Encoding<_CharTy>, _CharTy>(is_buffer_encodable<_Encoding<_CharTy>, _CharTy>{});
+}
+
 }  // namespace encoding
 
 }  // namespace configor
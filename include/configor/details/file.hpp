@@ -0,0 +1,185 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "exception.hpp"
+
+#include <cstddef>  // std::size_t
+#include <cstdio>   // std::FILE, std::fopen, std::fread, std::fclose
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+// Define CONFIGOR_DISABLE_MMAP to always read files into memory
+#ifndef CONFIGOR_DISABLE_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define __CONFIGOR_MMAP
+#endif
+#endif
+
+#if defined(__CONFIGOR_MMAP)
+#include <cerrno>      // errno, EINTR
+#include <fcntl.h>     // open, O_RDONLY
+#include <sys/mman.h>  // mmap, munmap, madvise
+#include <sys/stat.h>  // fstat, S_ISREG
+#include <unistd.h>    // read, close
+#endif
+
+namespace configor
+{
+
+namespace detail
+{
+
+//
+// file_buffer
+// the whole content of a file in contiguous memory
+// regular files are memory mapped, anything else (pipes, devices) is read into a buffer
+//
+
+class file_buffer
+{
+public:
+    explicit file_buffer(const std::string& path)
+        : data_(nullptr)
+        , size_(0)
+        , mapped_(false)
+        , buffer_()
+    {
+#if defined(__CONFIGOR_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            fail("cannot open file", path);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            const auto size = static_cast<std::size_t>(st.st_size);
+            void*      addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+#if defined(MADV_SEQUENTIAL)
+                ::madvise(addr, size, MADV_SEQUENTIAL);
+#endif
+                ::close(fd);
+                data_   = static_cast<const char*>(addr);
+                size_   = size;
+                mapped_ = true;
+                return;
+            }
+        }
+
+        std::size_t length = 0;
+        while (true)
+        {
+            if (buffer_.size() - length < chunk_size)
+                buffer_.resize(length + chunk_size);
+
+            const auto n = ::read(fd, &buffer_[length], buffer_.size() - length);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+            {
+                ::close(fd);
+                fail("cannot read file", path);
+            }
+            if (n == 0)
+                break;
+            length += static_cast<std::size_t>(n);
+        }
+        ::close(fd);
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            fail("cannot open file", path);
+        }
+
+        std::size_t length = 0;
+        while (true)
+        {
+            if (buffer_.size() - length < chunk_size)
+                buffer_.resize(length + chunk_size);
+
+            const auto n = std::fread(&buffer_[length], 1, buffer_.size() - length, file);
+            length += n;
+            if (n == 0)
+                break;
+        }
+
+        const bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        if (failed)
+        {
+            fail("cannot read file", path);
+        }
+#endif
+        buffer_.resize(length);
+        data_ = buffer_.empty() ? "" : buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    file_buffer(const file_buffer&) = delete;
+    file_buffer& operator=(const file_buffer&) = delete;
+
+    ~file_buffer()
+    {
+#if defined(__CONFIGOR_MMAP)
+        if (mapped_)
+        {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    inline const char* data() const
+    {
+        return data_;
+    }
+
+    inline std::size_t size() const
+    {
+        return size_;
+    }
+
+    inline bool is_mapped() const
+    {
+        return mapped_;
+    }
+
+private:
+    static void fail(const std::string& msg, const std::string& path)
+    {
+        throw configor_deserialization_error(msg + " '" + path + "'");
+    }
+
+private:
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    const char*       data_;
+    std::size_t       size_;
+    bool              mapped_;
+    std::vector<char> buffer_;
+};
+
+}  // namespace detail
+
+}  // namespace configor
@@ -0,0 +1,590 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "floating.hpp"
+
+#include <algorithm>    // std::copy, std::copy_backward, std::fill_n
+#include <cmath>        // std::signbit
+#include <cstddef>      // std::size_t
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstring>      // std::memcpy
+#include <limits>       // std::numeric_limits
+#include <type_traits>  // std::make_unsigned, std::is_signed, std::conditional
+
+namespace configor
+{
+
+namespace detail
+{
+
+namespace format
+{
+
+//
+// integer
+//
+
+// two decimal digits for each value in [0, 100)
+inline const char* digit_pairs()
+{
+    static const char table[] = "00010203040506070809"
+                                "10111213141516171819"
+                                "20212223242526272829"
+                                "30313233343536373839"
+                                "40414243444546474849"
+                                "50515253545556575859"
+                                "60616263646566676869"
+                                "70717273747576777879"
+                                "80818283848586878889"
+                                "90919293949596979899";
+    return table;
+}
+
+// writes the digits backwards, two at a time, ending at last
+// returns the first digit written
+template <typename _CharTy>
+inline _CharTy* write_digits_backward(_CharTy* last, uint32_t n)
+{
+    const char* pairs = digit_pairs();
+    while (n >= 100)
+    {
+        const uint32_t r = (n % 100) * 2;
+        n /= 100;
+        *--last = static_cast<_CharTy>(pairs[r + 1]);
+        *--last = static_cast<_CharTy>(pairs[r]);
+    }
+
+    if (n >= 10)
+    {
+        *--last = static_cast<_CharTy>(pairs[n * 2 + 1]);
+        *--last = static_cast<_CharTy>(pairs[n * 2]);
+    }
+    else
+    {
+        *--last = static_cast<_CharTy>('0' + n);
+    }
+    return last;
+}
+
+template <typename _CharTy>
+inline _CharTy* write_digits_backward(_CharTy* last, uint64_t n)
+{
+    const char* pairs = digit_pairs();
+    while (n > (std::numeric_limits<uint32_t>::max)())
+    {
+        const uint32_t r = static_cast<uint32_t>(n % 100) * 2;
+        n /= 100;
+        *--last = static_cast<_CharTy>(pairs[r + 1]);
+        *--last = static_cast<_CharTy>(pairs[r]);
+    }
+    return write_digits_backward(last, static_cast<uint32_t>(n));
+}
+
+// enough for the digits and the sign of any integer up to 64 bits
+constexpr int max_integer_length = 21;
+
+template <typename _IntTy>
+inline bool is_negative(_IntTy i, std::true_type)
+{
+    return i < 0;
+}
+
+template <typename _IntTy>
+inline bool is_negative(_IntTy, std::false_type)
+{
+    return false;
+}
+
+// writes an integer ending at last, returns the first character written
+template <typename _CharTy, typename _IntTy>
+inline _CharTy* write_integer_backward(_CharTy* last, _IntTy i)
+{
+    static_assert(sizeof(_IntTy) <= sizeof(uint64_t), "integer type is too large");
+
+    using unsigned_type = typename std::make_unsigned<_IntTy>::type;
+    using digits_type   = typename std::conditional<(sizeof(_IntTy) <= sizeof(uint32_t)), uint32_t, uint64_t>::type;
+
+    const bool    negative  = is_negative(i, std::is_signed<_IntTy>{});
+    unsigned_type magnitude = static_cast<unsigned_type>(i);
+    if (negative)
+        magnitude = static_cast<unsigned_type>(0 - magnitude);
+
+    _CharTy* first = write_digits_backward(last, static_cast<digits_type>(magnitude));
+    if (negative)
+        *--first = static_cast<_CharTy>('-');
+    return first;
+}
+
+//
+// hex
+//
+
+constexpr int json_hex_length = 6;
+
+// writes the escape \uXXXX with 4 uppercase hex digits of a code unit
+template <typename _CharTy>
+inline void write_json_hex(_CharTy* out, uint32_t code_unit)
+{
+    static const char digits[] = "0123456789ABCDEF";
+
+    out[0] = static_cast<_CharTy>('\\');
+    out[1] = static_cast<_CharTy>('u');
+    out[2] = static_cast<_CharTy>(digits[(code_unit >> 12) & 0xF]);
+    out[3] = static_cast<_CharTy>(digits[(code_unit >> 8) & 0xF]);
+    out[4] = static_cast<_CharTy>(digits[(code_unit >> 4) & 0xF]);
+    out[5] = static_cast<_CharTy>(digits[code_unit & 0xF]);
+}
+
+//
+// float
+// shortest representation which reads back to the same value, with the Grisu2 algorithm
+// see Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+//
+
+// a floating-point number f * 2^e with a 64-bit significand
+struct diyfp
+{
+    uint64_t f;
+    int      e;
+
+    static diyfp sub(const diyfp& x, const diyfp& y)
+    {
+        CONFIGOR_ASSERT(x.e == y.e && x.f >= y.f);
+        return diyfp{ x.f - y.f, x.e };
+    }
+
+    // the upper 64 bits of the product, rounded
+    static diyfp mul(const diyfp& x, const diyfp& y)
+    {
+        const floating::uint128 p = floating::full_multiplication(x.f, y.f);
+        return diyfp{ p.high + (p.low >> 63), x.e + y.e + 64 };
+    }
+
+    static diyfp normalize(const diyfp& x)
+    {
+        const int shift = floating::count_leading_zeros(x.f);
+        return diyfp{ x.f << shift, x.e - shift };
+    }
+
+    static diyfp normalize_to(const diyfp& x, int e)
+    {
+        return diyfp{ x.f << (x.e - e), e };
+    }
+};
+
+// the value and the middle points to its neighbours
+struct float_boundaries
+{
+    diyfp w;
+    diyfp minus;
+    diyfp plus;
+};
+
+template <typename _FloatTy>
+inline float_boundaries compute_boundaries(_FloatTy value)
+{
+    using format_type = floating::binary_format<_FloatTy>;
+    using bits_type   = typename format_type::bits_type;
+
+    const int      mantissa_bits = format_type::mantissa_explicit_bits;
+    const int      bias          = -format_type::minimum_exponent + mantissa_bits;
+    const uint64_t hidden_bit    = uint64_t(1) << mantissa_bits;
+
+    bits_type bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint64_t fraction = static_cast<uint64_t>(bits) & (hidden_bit - 1);
+    const int      exponent = static_cast<int>(bits >> mantissa_bits);
+
+    const diyfp v = (exponent == 0) ? diyfp{ fraction, 1 - bias } : diyfp{ fraction + hidden_bit, exponent - bias };
+
+    // the lower neighbour is closer if the value is a power of two, except the smallest normal
+    const bool  lower_closer = (fraction == 0 && exponent > 1);
+    const diyfp plus         = diyfp::normalize(diyfp{ 2 * v.f + 1, v.e - 1 });
+    const diyfp minus        = lower_closer ? diyfp{ 4 * v.f - 1, v.e - 2 } : diyfp{ 2 * v.f - 1, v.e - 1 };
+
+    return float_boundaries{ diyfp::normalize(v), diyfp::normalize_to(minus, plus.e), plus };
+}
+
+// the exponent of the scaled value is kept in [alpha, gamma], so the integral part fits in 32 bits
+constexpr int grisu_alpha = -60;
+constexpr int grisu_gamma = -32;
+
+struct cached_power
+{
+    uint64_t f;
+    int      e;
+    int      k;
+};
+
+// normalized approximations of 10^k for k in [-300, 340] with step 8
+inline cached_power get_cached_power(int e)
+{
+    static const cached_power powers[] = {
+            { 0xAB70FE17C79AC6CA, -1060, -300 },
+            { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+            { 0xBE5691EF416BD60C, -1007, -284 },
+            { 0x8DD01FAD907FFC3C, -980, -276 },
+            { 0xD3515C2831559A83, -954, -268 },
+            { 0x9D71AC8FADA6C9B5, -927, -260 },
+            { 0xEA9C227723EE8BCB, -901, -252 },
+            { 0xAECC49914078536D, -874, -244 },
+            { 0x823C12795DB6CE57, -847, -236 },
+            { 0xC21094364DFB5637, -821, -228 },
+            { 0x9096EA6F3848984F, -794, -220 },
+            { 0xD77485CB25823AC7, -768, -212 },
+            { 0xA086CFCD97BF97F4, -741, -204 },
+            { 0xEF340A98172AACE5, -715, -196 },
+            { 0xB23867FB2A35B28E, -688, -188 },
+            { 0x84C8D4DFD2C63F3B, -661, -180 },
+            { 0xC5DD44271AD3CDBA, -635, -172 },
+            { 0x936B9FCEBB25C996, -608, -164 },
+            { 0xDBAC6C247D62A584, -582, -156 },
+            { 0xA3AB66580D5FDAF6, -555, -148 },
+            { 0xF3E2F893DEC3F126, -529, -140 },
+            { 0xB5B5ADA8AAFF80B8, -502, -132 },
+            { 0x87625F056C7C4A8B, -475, -124 },
+            { 0xC9BCFF6034C13053, -449, -116 },
+            { 0x964E858C91BA2655, -422, -108 },
+            { 0xDFF9772470297EBD, -396, -100 },
+            { 0xA6DFBD9FB8E5B88F, -369, -92 },
+            { 0xF8A95FCF88747D94, -343, -84 },
+            { 0xB94470938FA89BCF, -316, -76 },
+            { 0x8A08F0F8BF0F156B, -289, -68 },
+            { 0xCDB02555653131B6, -263, -60 },
+            { 0x993FE2C6D07B7FAC, -236, -52 },
+            { 0xE45C10C42A2B3B06, -210, -44 },
+            { 0xAA242499697392D3, -183, -36 },
+            { 0xFD87B5F28300CA0E, -157, -28 },
+            { 0xBCE5086492111AEB, -130, -20 },
+            { 0x8CBCCC096F5088CC, -103, -12 },
+            { 0xD1B71758E219652C, -77, -4 },
+            { 0x9C40000000000000, -50, 4 },
+            { 0xE8D4A51000000000, -24, 12 },
+            { 0xAD78EBC5AC620000, 3, 20 },
+            { 0x813F3978F8940984, 30, 28 },
+            { 0xC097CE7BC90715B3, 56, 36 },
+            { 0x8F7E32CE7BEA5C70, 83, 44 },
+            { 0xD5D238A4ABE98068, 109, 52 },
+            { 0x9F4F2726179A2245, 136, 60 },
+            { 0xED63A231D4C4FB27, 162, 68 },
+            { 0xB0DE65388CC8ADA8, 189, 76 },
+            { 0x83C7088E1AAB65DB, 216, 84 },
+            { 0xC45D1DF942711D9A, 242, 92 },
+            { 0x924D692CA61BE758, 269, 100 },
+            { 0xDA01EE641A708DEA, 295, 108 },
+            { 0xA26DA3999AEF774A, 322, 116 },
+            { 0xF209787BB47D6B85, 348, 124 },
+            { 0xB454E4A179DD1877, 375, 132 },
+            { 0x865B86925B9BC5C2, 402, 140 },
+            { 0xC83553C5C8965D3D, 428, 148 },
+            { 0x952AB45CFA97A0B3, 455, 156 },
+            { 0xDE469FBD99A05FE3, 481, 164 },
+            { 0xA59BC234DB398C25, 508, 172 },
+            { 0xF6C69A72A3989F5C, 534, 180 },
+            { 0xB7DCBF5354E9BECE, 561, 188 },
+            { 0x88FCF317F22241E2, 588, 196 },
+            { 0xCC20CE9BD35C78A5, 614, 204 },
+            { 0x98165AF37B2153DF, 641, 212 },
+            { 0xE2A0B5DC971F303A, 667, 220 },
+            { 0xA8D9D1535CE3B396, 694, 228 },
+            { 0xFB9B7CD9A4A7443C, 720, 236 },
+            { 0xBB764C4CA7A44410, 747, 244 },
+            { 0x8BAB8EEFB6409C1A, 774, 252 },
+            { 0xD01FEF10A657842C, 800, 260 },
+            { 0x9B10A4E5E9913129, 827, 268 },
+            { 0xE7109BFBA19C0C9D, 853, 276 },
+            { 0xAC2820D9623BF429, 880, 284 },
+            { 0x80444B5E7AA7CF85, 907, 292 },
+            { 0xBF21E44003ACDD2D, 933, 300 },
+            { 0x8E679C2F5E44FF8F, 960, 308 },
+            { 0xD433179D9C8CB841, 986, 316 },
+            { 0x9E19DB92B4E31BA9, 1013, 324 },
+            { 0xEB96BF6EBADF77D9, 1039, 332 },
+            { 0xAF87023B9BF0EE6B, 1066, 340 },
+    };
+
+    const int min_decimal_exponent = -300;
+    const int decimal_step         = 8;
+
+    // k = ceil((alpha - e - 1) * log10(2))
+    const int f     = grisu_alpha - e - 1;
+    const int k     = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+    const int index = (-min_decimal_exponent + k + (decimal_step - 1)) / decimal_step;
+    CONFIGOR_ASSERT(index >= 0 && static_cast<std::size_t>(index) < sizeof(powers) / sizeof(powers[0]));
+
+    const cached_power& cached = powers[index];
+    CONFIGOR_ASSERT(grisu_alpha <= cached.e + e + 64 && cached.e + e + 64 <= grisu_gamma);
+    return cached;
+}
+
+// returns the number of decimal digits of n and the largest power of ten not greater than n
+inline int find_largest_pow10(uint32_t n, uint32_t& pow10)
+{
+    static const uint32_t powers[] = { 1,      10,      100,      1000,      10000,
+                                       100000, 1000000, 10000000, 100000000, 1000000000 };
+
+    int digits = 10;
+    while (digits > 1 && n < powers[digits - 1])
+        --digits;
+    pow10 = powers[digits - 1];
+    return digits;
+}
+
+// moves the last digit towards the value while it stays in the rounding interval
+template <typename _CharTy>
+inline void grisu_round(_CharTy* digits, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+{
+    while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        --digits[length - 1];
+        rest += ten_k;
+    }
+}
+
+// generates the shortest digits in (minus, plus) close to w
+// returns false if a digit was generated while a shorter result lies in the interval widened by the error,
+// in which case the digits are correct but may not be the shortest
+template <typename _CharTy>
+inline bool grisu_generate(_CharTy* digits, int& length, int& decimal_exponent, diyfp minus, diyfp w, diyfp plus)
+{
+    diyfp delta = diyfp::sub(plus, minus);
+    diyfp dist  = diyfp::sub(plus, w);
+
+    const diyfp one{ uint64_t(1) << -plus.e, plus.e };
+
+    uint32_t p1 = static_cast<uint32_t>(plus.f >> -one.e);
+    uint64_t p2 = plus.f & (one.f - 1);
+
+    // the boundaries are off by less than one unit each, so the interval may be wider by up to four units
+    // and its upper boundary higher by up to two units, which might carry into the last digit
+    bool shortest = true;
+
+    // the integral part
+    uint32_t pow10 = 0;
+    int      n     = find_largest_pow10(p1, pow10);
+    while (n > 0)
+    {
+        const uint32_t d = p1 / pow10;
+        p1 %= pow10;
+        digits[length++] = static_cast<_CharTy>('0' + d);
+        --n;
+
+        const uint64_t rest  = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        const uint64_t ten_k = static_cast<uint64_t>(pow10) << -one.e;
+        if (rest <= delta.f)
+        {
+            decimal_exponent += n;
+            grisu_round(digits, length, dist.f, delta.f, rest, ten_k);
+            return shortest;
+        }
+        if (rest <= delta.f + 4 || rest + 2 >= ten_k)
+            shortest = false;
+        pow10 /= 10;
+    }
+
+    // the fractional part
+    int      m    = 0;
+    uint64_t unit = 1;
+    while (true)
+    {
+        p2 *= 10;
+        const uint64_t d = p2 >> -one.e;
+        p2 &= one.f - 1;
+        digits[length++] = static_cast<_CharTy>('0' + d);
+        ++m;
+
+        delta.f *= 10;
+        dist.f *= 10;
+        unit *= 10;
+        if (p2 <= delta.f)
+            break;
+        if (p2 <= delta.f + 4 * unit || p2 + 2 * unit >= one.f)
+            shortest = false;
+    }
+    decimal_exponent -= m;
+    grisu_round(digits, length, dist.f, delta.f, p2, one.f);
+    return shortest;
+}
+
+// the value must be positive and finite
+// the value is digits * 10^decimal_exponent
+// returns false if the digits may not be the shortest, see grisu_generate
+template <typename _CharTy, typename _FloatTy>
+inline bool grisu2(_CharTy* digits, int& length, int& decimal_exponent, _FloatTy value)
+{
+    const float_boundaries b = compute_boundaries(value);
+
+    const cached_power cached = get_cached_power(b.plus.e);
+    const diyfp        c{ cached.f, cached.e };
+
+    const diyfp w     = diyfp::mul(b.w, c);
+    const diyfp minus = diyfp::mul(b.minus, c);
+    const diyfp plus  = diyfp::mul(b.plus, c);
+
+    length           = 0;
+    decimal_exponent = -cached.k;
+
+    // the boundaries are shrunk by one unit, which covers the error of the multiplications
+    return grisu_generate(digits, length, decimal_exponent, diyfp{ minus.f + 1, minus.e }, w,
+                          diyfp{ plus.f - 1, plus.e });
+}
+
+// drops digits while the value still reads back exactly, for the rare results of grisu2 which may not be
+// the shortest, e.g. 9999999999999999e7 for 1e23
+// one of the two neighbours with a digit less reads back exactly if any shorter digits do
+template <typename _CharTy, typename _FloatTy>
+inline void shorten_digits(_CharTy* digits, int& length, int& decimal_exponent, _FloatTy value)
+{
+    while (length > 1)
+    {
+        uint64_t lower = 0;
+        for (int i = 0; i < length - 1; ++i)
+            lower = lower * 10 + static_cast<uint64_t>(digits[i] - '0');
+
+        // the nearer neighbour first
+        const bool     round_up = (digits[length - 1] >= '5');
+        const uint64_t first    = round_up ? lower + 1 : lower;
+        const uint64_t second   = round_up ? lower : lower + 1;
+
+        uint64_t shorter = 0;
+        if (floating::eisel_lemire<_FloatTy>(first, decimal_exponent + 1) == value)
+            shorter = first;
+        else if (floating::eisel_lemire<_FloatTy>(second, decimal_exponent + 1) == value)
+            shorter = second;
+        else
+            break;
+
+        decimal_exponent += 1;
+        while (shorter % 10 == 0)
+        {
+            shorter /= 10;
+            decimal_exponent += 1;
+        }
+
+        _CharTy  buffer[max_integer_length];
+        _CharTy* last = buffer + max_integer_length;
+        _CharTy* str  = write_digits_backward(last, shorter);
+        length        = static_cast<int>(last - str);
+        std::copy(str, last, digits);
+    }
+}
+
+// enough for the sign, 17 digits, the point, the padding zeros and the exponent
+constexpr int max_float_length = 32;
+
+// writes the exponent with a sign and at least two digits, as printf("%g") does
+template <typename _CharTy>
+inline _CharTy* write_exponent(_CharTy* out, int e)
+{
+    *out++ = static_cast<_CharTy>(e < 0 ? '-' : '+');
+    if (e < 0)
+        e = -e;
+
+    _CharTy  buffer[4];
+    _CharTy* last  = buffer + 4;
+    _CharTy* first = write_digits_backward(last, static_cast<uint32_t>(e));
+    if (last - first < 2)
+        *--first = static_cast<_CharTy>('0');
+    return std::copy(first, last, out);
+}
+
+// writes the shortest representation of a finite value, which always has a point or an exponent
+// decimal notation is used for exponents in [-4, digits10], scientific notation otherwise
+// returns the end of the written characters
+template <typename _CharTy, typename _FloatTy>
+inline _CharTy* write_float(_CharTy* out, _FloatTy value)
+{
+    static_assert(floating::has_binary_format<_FloatTy>::value, "float type is not supported");
+
+    if (std::signbit(value))
+    {
+        *out++ = static_cast<_CharTy>('-');
+        value  = -value;
+    }
+
+    if (value == 0)
+    {
+        *out++ = static_cast<_CharTy>('0');
+        *out++ = static_cast<_CharTy>('.');
+        *out++ = static_cast<_CharTy>('0');
+        return out;
+    }
+
+    int length = 0, decimal_exponent = 0;
+    if (!grisu2(out, length, decimal_exponent, value))
+        shorten_digits(out, length, decimal_exponent, value);
+
+    const int min_exp = -4;
+    const int max_exp = std::numeric_limits<_FloatTy>::digits10;
+
+    // the value is 0.digits * 10^n, or d.igits * 10^(n - 1) in scientific notation
+    const int k = length;
+    const int n = length + decimal_exponent;
+
+    if (k <= n && n - 1 <= max_exp)
+    {
+        // digits000.0
+        std::fill_n(out + k, n - k, static_cast<_CharTy>('0'));
+        out[n]     = static_cast<_CharTy>('.');
+        out[n + 1] = static_cast<_CharTy>('0');
+        return out + n + 2;
+    }
+
+    if (0 < n && n - 1 <= max_exp)
+    {
+        // dig.its
+        std::copy_backward(out + n, out + k, out + k + 1);
+        out[n] = static_cast<_CharTy>('.');
+        return out + k + 1;
+    }
+
+    if (min_exp <= n - 1 && n <= 0)
+    {
+        // 0.000digits
+        std::copy_backward(out, out + k, out + k + 2 - n);
+        out[0] = static_cast<_CharTy>('0');
+        out[1] = static_cast<_CharTy>('.');
+        std::fill_n(out + 2, -n, static_cast<_CharTy>('0'));
+        return out + k + 2 - n;
+    }
+
+    if (k == 1)
+    {
+        // de+00
+        ++out;
+    }
+    else
+    {
+        // d.igitse+00
+        std::copy_backward(out + 1, out + k, out + k + 1);
+        out[1] = static_cast<_CharTy>('.');
+        out += k + 1;
+    }
+    *out++ = static_cast<_CharTy>('e');
+    return write_exponent(out, n - 1);
+}
+
+}  // namespace format
+
+}  // namespace detail
+
+}  // namespace configor
@@ -0,0 +1,277 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "string_view.hpp"
+
+#include <cstddef>  // std::size_t
+#include <memory>   // std::allocator
+#include <ostream>  // std::basic_ostream
+#include <string>   // std::char_traits, std::basic_string
+#include <utility>  // std::move, std::swap
+
+namespace configor
+{
+
+//
+// basic_insitu_string
+// a string that either refers to characters owned by someone else (usually the buffer being parsed)
+// or owns a copy of them, any modification turns a referring string into an owning one
+//
+
+template <typename _CharTy, typename _TraitsTy = std::char_traits<_CharTy>, typename _AllocTy = std::allocator<_CharTy>>
+class basic_insitu_string
+{
+public:
+    using char_type      = _CharTy;
+    using value_type     = _CharTy;
+    using traits_type    = _TraitsTy;
+    using allocator_type = _AllocTy;
+    using size_type      = std::size_t;
+    using string_type    = std::basic_string<char_type, traits_type, allocator_type>;
+    using view_type      = basic_string_view<char_type, traits_type>;
+    using const_iterator = const char_type*;
+    using iterator       = const_iterator;
+
+    basic_insitu_string()
+        : str_()
+        , view_(nullptr)
+        , view_size_(0)
+    {
+    }
+
+    basic_insitu_string(const char_type* str)
+        : str_(str)
+        , view_(nullptr)
+        , view_size_(0)
+    {
+    }
+
+    basic_insitu_string(const char_type* str, size_type size)
+        : str_(str, size)
+        , view_(nullptr)
+        , view_size_(0)
+    {
+    }
+
+    basic_insitu_string(const string_type& str)
+        : str_(str)
+        , view_(nullptr)
+        , view_size_(0)
+    {
+    }
+
+    basic_insitu_string(string_type&& str)
+        : str_(std::move(str))
+        , view_(nullptr)
+        , view_size_(0)
+    {
+    }
+
+    basic_insitu_string(const basic_insitu_string& other)
+        : str_(other.str_)
+        , view_(other.view_)
+        , view_size_(other.view_size_)
+    {
+    }
+
+    basic_insitu_string(basic_insitu_string&& other)
+        : str_(std::move(other.str_))
+        , view_(other.view_)
+        , view_size_(other.view_size_)
+    {
+        other.view_      = nullptr;
+        other.view_size_ = 0;
+    }
+
+    basic_insitu_string& operator=(basic_insitu_string other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    // refer to [first, last) without copying, the characters must outlive this string
+    void assign_view(const char_type* first, const char_type* last)
+    {
+        str_.clear();
+        view_      = first;
+        view_size_ = static_cast<size_type>(last - first);
+    }
+
+    inline bool is_view() const
+    {
+        return view_ != nullptr;
+    }
+
+    inline const char_type* data() const
+    {
+        return view_ ? view_ : str_.data();
+    }
+
+    inline size_type size() const
+    {
+        return view_ ? view_size_ : str_.size();
+    }
+
+    inline size_type length() const
+    {
+        return size();
+    }
+
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+
+    inline const_iterator begin() const
+    {
+        return data();
+    }
+
+    inline const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    inline const char_type& operator[](size_type index) const
+    {
+        return data()[index];
+    }
+
+    inline view_type view() const
+    {
+        return view_type(data(), size());
+    }
+
+    inline string_type str() const
+    {
+        return string_type(data(), size());
+    }
+
+    operator string_type() const
+    {
+        return str();
+    }
+
+    void clear()
+    {
+        str_.clear();
+        view_      = nullptr;
+        view_size_ = 0;
+    }
+
+    void reserve(size_type size)
+    {
+        own();
+        str_.reserve(size);
+    }
+
+    void push_back(char_type ch)
+    {
+        own();
+        str_.push_back(ch);
+    }
+
+    basic_insitu_string& append(const char_type* str, size_type size)
+    {
+        own();
+        str_.append(str, size);
+        return *this;
+    }
+
+    template <typename _InputIt>
+    basic_insitu_string& append(_InputIt first, _InputIt last)
+    {
+        own();
+        str_.append(first, last);
+        return *this;
+    }
+
+    void swap(basic_insitu_string& other)
+    {
+        std::swap(str_, other.str_);
+        std::swap(view_, other.view_);
+        std::swap(view_size_, other.view_size_);
+    }
+
+    friend inline bool operator==(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() == rhs.view();
+    }
+
+    friend inline bool operator!=(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() != rhs.view();
+    }
+
+    friend inline bool operator<(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() < rhs.view();
+    }
+
+    friend inline bool operator<=(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() <= rhs.view();
+    }
+
+    friend inline bool operator>(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() > rhs.view();
+    }
+
+    friend inline bool operator>=(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.view() >= rhs.view();
+    }
+
+    friend inline std::basic_ostream<char_type, traits_type>& operator<<(std::basic_ostream<char_type, traits_type>& os,
+                                                                         const basic_insitu_string&                  s)
+    {
+        return os << s.view();
+    }
+
+private:
+    void own()
+    {
+        if (view_)
+        {
+            str_.assign(view_, view_size_);
+            view_      = nullptr;
+            view_size_ = 0;
+        }
+    }
+
+private:
+    string_type      str_;
+    const char_type* view_;
+    size_type        view_size_;
+};
+
+template <typename _CharTy, typename _TraitsTy, typename _AllocTy>
+inline void swap(basic_insitu_string<_CharTy, _TraitsTy, _AllocTy>& lhs,
+                 basic_insitu_string<_CharTy, _TraitsTy, _AllocTy>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+using insitu_string  = basic_insitu_string<char>;
+using winsitu_string = basic_insitu_string<wchar_t>;
+
+}  // namespace configor
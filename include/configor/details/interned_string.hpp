@@ -0,0 +1,340 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "string_view.hpp"
+
+#include <cstddef>        // std::size_t
+#include <memory>         // std::allocator, std::shared_ptr, std::make_shared
+#include <ostream>        // std::basic_ostream
+#include <string>         // std::char_traits, std::basic_string
+#include <unordered_map>  // std::unordered_map
+#include <utility>        // std::move, std::swap
+
+namespace configor
+{
+
+//
+// basic_intern_table
+// shares one copy of each distinct string, usually the keys of parsed objects
+// the table is not thread-safe
+//
+
+template <typename _CharTy, typename _TraitsTy = std::char_traits<_CharTy>, typename _AllocTy = std::allocator<_CharTy>>
+class basic_intern_table
+{
+public:
+    using char_type   = _CharTy;
+    using size_type   = std::size_t;
+    using string_type = std::basic_string<char_type, _TraitsTy, _AllocTy>;
+    using shared_type = std::shared_ptr<const string_type>;
+    using view_type   = basic_string_view<char_type, _TraitsTy>;
+
+    // strings are not interned any more once the table holds max_size strings
+    explicit basic_intern_table(size_type max_size = 65536)
+        : strings_()
+        , max_size_(max_size)
+    {
+    }
+
+    // returns the shared copy of the characters, or nullptr if the table is full
+    shared_type intern(const char_type* data, size_type size)
+    {
+        const auto iter = strings_.find(view_type(data, size));
+        if (iter != strings_.end())
+            return iter->second;
+
+        if (strings_.size() >= max_size_)
+            return nullptr;
+
+        auto shared = std::make_shared<const string_type>(data, size);
+        strings_.emplace(view_type(shared->data(), shared->size()), shared);
+        return shared;
+    }
+
+    inline size_type size() const
+    {
+        return strings_.size();
+    }
+
+    // the strings already shared stay valid
+    void clear()
+    {
+        strings_.clear();
+    }
+
+private:
+    struct view_hash
+    {
+        std::size_t operator()(const view_type& view) const
+        {
+            // FNV-1a
+            std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+            for (const auto ch : view)
+            {
+                hash ^= static_cast<std::size_t>(ch);
+                hash *= static_cast<std::size_t>(1099511628211ULL);
+            }
+            return hash;
+        }
+    };
+
+    std::unordered_map<view_type, shared_type, view_hash> strings_;
+    size_type                                              max_size_;
+};
+
+using intern_table  = basic_intern_table<char>;
+using wintern_table = basic_intern_table<wchar_t>;
+
+//
+// basic_interned_string
+// a string that either shares the characters interned by a basic_intern_table or owns a copy of them,
+// equal shared strings are compared by pointer, any modification turns a shared string into an owning one
+//
+
+template <typename _CharTy, typename _TraitsTy = std::char_traits<_CharTy>, typename _AllocTy = std::allocator<_CharTy>>
+class basic_interned_string
+{
+public:
+    using char_type      = _CharTy;
+    using value_type     = _CharTy;
+    using traits_type    = _TraitsTy;
+    using allocator_type = _AllocTy;
+    using size_type      = std::size_t;
+    using string_type    = std::basic_string<char_type, traits_type, allocator_type>;
+    using shared_type    = std::shared_ptr<const string_type>;
+    using view_type      = basic_string_view<char_type, traits_type>;
+    using const_iterator = const char_type*;
+    using iterator       = const_iterator;
+
+    basic_interned_string()
+        : str_()
+        , shared_()
+    {
+    }
+
+    basic_interned_string(const char_type* str)
+        : str_(str)
+        , shared_()
+    {
+    }
+
+    basic_interned_string(const char_type* str, size_type size)
+        : str_(str, size)
+        , shared_()
+    {
+    }
+
+    basic_interned_string(const string_type& str)
+        : str_(str)
+        , shared_()
+    {
+    }
+
+    basic_interned_string(string_type&& str)
+        : str_(std::move(str))
+        , shared_()
+    {
+    }
+
+    basic_interned_string(const basic_interned_string& other)
+        : str_(other.shared_ ? string_type() : other.str_)
+        , shared_(other.shared_)
+    {
+    }
+
+    basic_interned_string(basic_interned_string&& other)
+        : str_()
+        , shared_(std::move(other.shared_))
+    {
+        // a shared string leaves its buffer to be reused by the moved-from string
+        if (!shared_)
+            str_.swap(other.str_);
+    }
+
+    basic_interned_string& operator=(basic_interned_string other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    // share the characters of an interned string
+    void assign_shared(shared_type shared)
+    {
+        str_.clear();
+        shared_ = std::move(shared);
+    }
+
+    inline bool is_shared() const
+    {
+        return shared_ != nullptr;
+    }
+
+    inline const char_type* data() const
+    {
+        return shared_ ? shared_->data() : str_.data();
+    }
+
+    inline size_type size() const
+    {
+        return shared_ ? shared_->size() : str_.size();
+    }
+
+    inline size_type length() const
+    {
+        return size();
+    }
+
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+
+    inline const_iterator begin() const
+    {
+        return data();
+    }
+
+    inline const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    inline const char_type& operator[](size_type index) const
+    {
+        return data()[index];
+    }
+
+    inline view_type view() const
+    {
+        return view_type(data(), size());
+    }
+
+    inline string_type str() const
+    {
+        return shared_ ? *shared_ : str_;
+    }
+
+    operator string_type() const
+    {
+        return str();
+    }
+
+    void clear()
+    {
+        str_.clear();
+        shared_.reset();
+    }
+
+    void reserve(size_type size)
+    {
+        own();
+        str_.reserve(size);
+    }
+
+    void push_back(char_type ch)
+    {
+        own();
+        str_.push_back(ch);
+    }
+
+    basic_interned_string& append(const char_type* str, size_type size)
+    {
+        own();
+        str_.append(str, size);
+        return *this;
+    }
+
+    template <typename _InputIt>
+    basic_interned_string& append(_InputIt first, _InputIt last)
+    {
+        own();
+        str_.append(first, last);
+        return *this;
+    }
+
+    void swap(basic_interned_string& other)
+    {
+        std::swap(str_, other.str_);
+        std::swap(shared_, other.shared_);
+    }
+
+    friend inline bool operator==(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return (lhs.shared_ && lhs.shared_ == rhs.shared_) || lhs.view() == rhs.view();
+    }
+
+    friend inline bool operator!=(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend inline bool operator<(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return !(lhs.shared_ && lhs.shared_ == rhs.shared_) && lhs.view() < rhs.view();
+    }
+
+    friend inline bool operator<=(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    friend inline bool operator>(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    friend inline bool operator>=(const basic_interned_string& lhs, const basic_interned_string& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    friend inline std::basic_ostream<char_type, traits_type>& operator<<(std::basic_ostream<char_type, traits_type>& os,
+                                                                         const basic_interned_string&                s)
+    {
+        return os << s.view();
+    }
+
+private:
+    void own()
+    {
+        if (shared_)
+        {
+            str_.assign(shared_->data(), shared_->size());
+            shared_.reset();
+        }
+    }
+
+private:
+    string_type str_;
+    shared_type shared_;
+};
+
+template <typename _CharTy, typename _TraitsTy, typename _AllocTy>
+inline void swap(basic_interned_string<_CharTy, _TraitsTy, _AllocTy>& lhs,
+                 basic_interned_string<_CharTy, _TraitsTy, _AllocTy>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+using interned_string  = basic_interned_string<char>;
+using winterned_string = basic_interned_string<wchar_t>;
+
+}  // namespace configor
@@ -0,0 +1,401 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "file.hpp"
+#include "stream.hpp"
+
+#include <algorithm>           // std::max, std::min
+#include <condition_variable>  // std::condition_variable
+#include <cstddef>             // std::size_t
+#include <exception>           // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>          // std::function
+#include <initializer_list>    // std::initializer_list
+#include <iterator>            // std::distance
+#include <mutex>               // std::mutex, std::unique_lock, std::lock_guard
+#include <ostream>             // std::basic_ostream
+#include <string>              // std::basic_string, std::char_traits
+#include <thread>              // std::thread
+#include <utility>             // std::move
+#include <vector>              // std::vector
+
+namespace configor
+{
+
+namespace detail
+{
+
+//
+// run_batches
+// runs work(i) for every batch on a pool of threads and done(i) on the calling thread in batch order,
+// at most `window` batches are processed ahead of the last one done
+// the first exception thrown by work or done is rethrown after all threads have stopped
+//
+
+template <typename _WorkFn, typename _DoneFn>
+void run_batches(std::size_t count, std::size_t threads, std::size_t window, _WorkFn work, _DoneFn done)
+{
+    if (threads <= 1 || count <= 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            work(i);
+            done(i);
+        }
+        return;
+    }
+
+    std::mutex                      mutex;
+    std::condition_variable         cv;
+    std::vector<char>               finished(count, 0);
+    std::vector<std::exception_ptr> errors(count);
+    std::size_t                     next     = 0;
+    std::size_t                     consumed = 0;
+    bool                            stopped  = false;
+
+    auto worker = [&]()
+    {
+        while (true)
+        {
+            std::size_t i = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return stopped || next >= count || next < consumed + window; });
+                if (stopped || next >= count)
+                    return;
+                i = next++;
+            }
+
+            std::exception_ptr error;
+            try
+            {
+                work(i);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished[i] = 1;
+                errors[i]   = error;
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve((std::min)(threads, count));
+    for (std::size_t i = 0; i < (std::min)(threads, count); ++i)
+        pool.emplace_back(worker);
+
+    std::exception_ptr error;
+    try
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return finished[i] != 0; });
+            }
+
+            if (errors[i])
+                std::rethrow_exception(errors[i]);
+            done(i);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed = i + 1;
+            }
+            cv.notify_all();
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : pool)
+        t.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+//
+// ndjson
+// newline-delimited json, one value per line, records are parsed and serialized on a pool of threads
+//
+
+template <typename _JsonTy>
+struct ndjson
+{
+    using value_type        = typename _JsonTy::value;
+    using char_type         = typename value_type::char_type;
+    using parser_type       = typename _JsonTy::parser;
+    using parser_option     = typename _JsonTy::parser::option;
+    using serializer_option = typename _JsonTy::serializer::option;
+
+    class reader
+    {
+    public:
+        using callback = std::function<void(value_type&)>;
+
+        // zero threads means one per hardware thread
+        explicit reader(std::size_t threads = 0)
+            : threads_(threads ? threads : (std::max)(std::thread::hardware_concurrency(), 1u))
+            , ordered_(true)
+            , batch_size_(1 << 20)
+        {
+        }
+
+        // records are handed to the callback in input order on the calling thread,
+        // otherwise the callback is called concurrently by the worker threads as soon as they are parsed
+        inline reader& set_ordered(bool ordered)
+        {
+            ordered_ = ordered;
+            return *this;
+        }
+
+        // approximate number of characters parsed by a thread at once
+        inline reader& set_batch_size(std::size_t size)
+        {
+            batch_size_ = (std::max)(size, std::size_t(1));
+            return *this;
+        }
+
+        void parse(const char_type* buffer, std::size_t size, const callback& cb,
+                   std::initializer_list<parser_option> options = {}) const
+        {
+            const auto batches = split(buffer, buffer + size);
+            const auto count   = batches.size() - 1;
+
+            if (!ordered_)
+            {
+                run_batches(
+                    count, threads_, count,
+                    [&](std::size_t i) { parse_batch(batches[i], batches[i + 1], cb, options); },
+                    [](std::size_t) {});
+                return;
+            }
+
+            // records before an invalid one are still handed to the callback
+            std::vector<std::vector<value_type>> results(count);
+            std::vector<std::exception_ptr>      errors(count);
+            run_batches(
+                count, threads_, threads_ * 2,
+                [&](std::size_t i)
+                {
+                    try
+                    {
+                        auto collect = [&](value_type& v) { results[i].push_back(std::move(v)); };
+                        parse_batch(batches[i], batches[i + 1], collect, options);
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                },
+                [&](std::size_t i)
+                {
+                    for (auto& v : results[i])
+                        cb(v);
+                    std::vector<value_type>().swap(results[i]);
+
+                    if (errors[i])
+                        std::rethrow_exception(errors[i]);
+                });
+        }
+
+        std::vector<value_type> parse(const char_type* buffer, std::size_t size,
+                                      std::initializer_list<parser_option> options = {}) const
+        {
+            std::vector<value_type> values;
+            reader(*this).set_ordered(true).parse(
+                buffer, size, [&](value_type& v) { values.push_back(std::move(v)); }, options);
+            return values;
+        }
+
+        // strings are always copied out of the file, which is released once parsing finishes
+        void parse_file(const std::string& path, const callback& cb,
+                        std::initializer_list<parser_option> options = {}) const
+        {
+            file_buffer         file{ path };
+            const parser_option copied = copy_strings(options);
+            parse(reinterpret_cast<const char_type*>(file.data()), file.size() / sizeof(char_type), cb, { copied });
+        }
+
+        std::vector<value_type> parse_file(const std::string& path,
+                                           std::initializer_list<parser_option> options = {}) const
+        {
+            file_buffer         file{ path };
+            const parser_option copied = copy_strings(options);
+            return parse(reinterpret_cast<const char_type*>(file.data()), file.size() / sizeof(char_type), { copied });
+        }
+
+    private:
+        // the options followed by turning off in-situ strings
+        static parser_option copy_strings(std::initializer_list<parser_option> options)
+        {
+            std::vector<parser_option> list(options);
+            return [list](parser_type& p)
+            {
+                for (const auto& opt : list)
+                    opt(p);
+                p.set_insitu_strings(false);
+            };
+        }
+
+        // batch boundaries, every batch ends after a line break or at the end of input
+        std::vector<const char_type*> split(const char_type* first, const char_type* last) const
+        {
+            std::vector<const char_type*> batches{ first };
+            while (first != last)
+            {
+                const auto* ptr = first + (std::min)(batch_size_, static_cast<std::size_t>(last - first));
+                if (ptr != last)
+                {
+                    ptr = std::char_traits<char_type>::find(ptr, static_cast<std::size_t>(last - ptr), '\n');
+                    ptr = ptr ? ptr + 1 : last;
+                }
+                batches.push_back(ptr);
+                first = ptr;
+            }
+            return batches;
+        }
+
+        template <typename _Fn>
+        static void parse_batch(const char_type* first, const char_type* last, const _Fn& fn,
+                                std::initializer_list<parser_option> options)
+        {
+            while (first != last)
+            {
+                auto* eol = std::char_traits<char_type>::find(first, static_cast<std::size_t>(last - first), '\n');
+                if (eol == nullptr)
+                    eol = last;
+
+                if (!is_blank(first, eol))
+                {
+                    value_type v;
+                    _JsonTy::parse(v, first, eol - first, options);
+                    fn(v);
+                }
+                first = (eol == last) ? last : eol + 1;
+            }
+        }
+
+        static bool is_blank(const char_type* first, const char_type* last)
+        {
+            for (; first != last; ++first)
+            {
+                if (*first != ' ' && *first != '\t' && *first != '\r')
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        std::size_t threads_;
+        bool        ordered_;
+        std::size_t batch_size_;
+    };
+
+    class writer
+    {
+    public:
+        using string_type = std::basic_string<char_type>;
+
+        // zero threads means one per hardware thread
+        explicit writer(std::size_t threads = 0)
+            : threads_(threads ? threads : (std::max)(std::thread::hardware_concurrency(), 1u))
+            , batch_size_(1024)
+        {
+        }
+
+        // number of records serialized by a thread at once
+        inline writer& set_batch_size(std::size_t size)
+        {
+            batch_size_ = (std::max)(size, std::size_t(1));
+            return *this;
+        }
+
+        // writes one record per line in order, indentation must not be enabled in the options
+        template <typename _RandomIt>
+        void dump(std::basic_ostream<char_type>& os, _RandomIt first, _RandomIt last,
+                  std::initializer_list<serializer_option> options = {}) const
+        {
+            const auto total = static_cast<std::size_t>(std::distance(first, last));
+            const auto count = (total + batch_size_ - 1) / batch_size_;
+
+            std::vector<string_type> results(count);
+            run_batches(
+                count, threads_, threads_ * 2,
+                [&](std::size_t i)
+                {
+                    const auto begin = first + static_cast<std::ptrdiff_t>(i * batch_size_);
+                    const auto end   = first + static_cast<std::ptrdiff_t>((std::min)(total, (i + 1) * batch_size_));
+
+                    fast_string_ostreambuf<char_type> buf{ results[i] };
+                    std::basic_ostream<char_type>     os{ &buf };
+                    for (auto iter = begin; iter != end; ++iter)
+                    {
+                        _JsonTy::dump(os, *iter, options);
+                        os.put('\n');
+                    }
+                },
+                [&](std::size_t i)
+                {
+                    os.write(results[i].data(), static_cast<std::streamsize>(results[i].size()));
+                    string_type().swap(results[i]);
+                });
+        }
+
+        void dump(std::basic_ostream<char_type>& os, const std::vector<value_type>& values,
+                  std::initializer_list<serializer_option> options = {}) const
+        {
+            dump(os, values.begin(), values.end(), options);
+        }
+
+        string_type dump(const std::vector<value_type>&         values,
+                         std::initializer_list<serializer_option> options = {}) const
+        {
+            string_type                       result;
+            fast_string_ostreambuf<char_type> buf{ result };
+            std::basic_ostream<char_type>     os{ &buf };
+            dump(os, values.begin(), values.end(), options);
+            return result;
+        }
+
+    private:
+        std::size_t threads_;
+        std::size_t batch_size_;
+    };
+};
+
+}  // namespace detail
+
+}  // namespace configor
@@ -20,13 +20,24 @@
 
 #pragma once
 #include "encoding.hpp"
+#include "file.hpp"
+#include "floating.hpp"
+#include "interned_string.hpp"
+#include "sax.hpp"
+#include "simd.hpp"
 #include "stream.hpp"
 #include "token.hpp"
 #include "value.hpp"
 
+#include <cstddef>           // std::size_t
 #include <initializer_list>  // std::initializer_list
 #include <istream>           // std::basic_istream
+#include <limits>            // std::numeric_limits
 #include <locale>            // std::locale
+#include <string>            // std::char_traits, std::string
+#include <type_traits>       // std::true_type, std::false_type, std::enable_if, std::is_integral
+#include <utility>           // std::move, std::declval
+#include <vector>            // std::vector
 
 namespace configor
 {
@@ -34,7 +45,9 @@ namespace configor
 namespace detail
 {
 
-template <typename _ValTy, typename _SourceCharTy>
+// the tokenizer is called through _DerivedTy without virtual calls,
+// see the specialization below for parsers which implement it with virtual functions
+template <typename _ValTy, typename _SourceCharTy, typename _DerivedTy = void>
 class basic_parser
 {
 public:
@@ -44,21 +57,65 @@ public:
 
     basic_parser(std::basic_istream<source_char_type>& is)
         : is_(is.rdbuf())
+        , buf_()
+        , buffer_(nullptr)
+        , buffer_end_(nullptr)
         , err_handler_(nullptr)
         , source_decoder_(nullptr)
+        , source_buffer_decoder_(nullptr)
+        , source_utf8_(false)
+        , buffer_decoder_(nullptr)
         , target_encoder_(nullptr)
+        , string_buffer_()
+        , max_depth_((std::numeric_limits<std::size_t>::max)())
+        , nesting_()
+        , intern_table_(nullptr)
+        , owned_intern_table_()
     {
         is_.unsetf(std::ios_base::skipws);
         is_.imbue(std::locale(std::locale::classic(), is.getloc(), std::locale::collate | std::locale::ctype));
     }
 
-    virtual void parse(value_type& c)
+    basic_parser(const source_char_type* first, const source_char_type* last)
+        : is_(nullptr)
+        , buf_(first, last)
+        , buffer_(first)
+        , buffer_end_(last)
+        , err_handler_(nullptr)
+        , source_decoder_(nullptr)
+        , source_buffer_decoder_(nullptr)
+        , source_utf8_(false)
+        , buffer_decoder_(nullptr)
+        , target_encoder_(nullptr)
+        , string_buffer_()
+        , max_depth_((std::numeric_limits<std::size_t>::max)())
+        , nesting_()
+        , intern_table_(nullptr)
+        , owned_intern_table_()
+    {
+        // the stream is only used by encodings which cannot decode a buffer directly
+        is_.rdbuf(&buf_);
+        is_.unsetf(std::ios_base::skipws);
+    }
+
+    void parse(value_type& c)
+    {
+        value_builder<value_type> builder{ c };
+        sax_parse(builder);
+    }
+
+    // returns false if parsing was stopped by the handler or an error was handled
+    template <typename _HandlerTy>
+    bool sax_parse(_HandlerTy& handler)
     {
         try
         {
-            do_parse(c, token_type::uninitialized);
-            if (scan() != token_type::end_of_input)
+            if (!do_sax_parse(handler, derived().scan()))
+                return false;
+
+            if (derived().scan() != token_type::end_of_input)
                 fail(token_type::end_of_input);
+            return true;
         }
         catch (...)
         {
@@ -67,6 +124,7 @@ public:
             else
                 throw;
         }
+        return false;
     }
 
     inline void set_error_handler(configor::error_handler* eh)
@@ -74,16 +132,354 @@ public:
         err_handler_ = eh;
     }
 
+    inline void set_max_depth(std::size_t max_depth)
+    {
+        max_depth_ = max_depth;
+    }
+
+    inline std::size_t get_max_depth() const
+    {
+        return max_depth_;
+    }
+
+    // keys are interned by the table, or a table owned by the parser if nullptr
+    inline void set_intern_table(basic_intern_table<target_char_type>* table)
+    {
+        intern_table_ = table ? table : &owned_intern_table_;
+    }
+
     template <template <class> class _Encoding>
     inline void set_source_encoding()
     {
-        source_decoder_ = _Encoding<source_char_type>::decode;
+        using encoding_type    = _Encoding<source_char_type>;
+        using buffer_decodable = encoding::is_buffer_decodable<encoding_type, source_char_type>;
+
+        source_decoder_        = encoding_type::decode;
+        source_buffer_decoder_ = get_buffer_decoder<encoding_type>(buffer_decodable{});
+        source_utf8_           = encoding::is_utf8_encoding<encoding_type>::value;
+        buffer_decoder_        = (buffer_end_ != nullptr) ? source_buffer_decoder_ : nullptr;
+    }
+
+    inline bool is_source_utf8() const
+    {
+        return source_utf8_;
     }
 
     template <template <class> class _Encoding>
     inline void set_target_encoding()
     {
-        target_encoder_ = _Encoding<target_char_type>::encode;
+        target_encoder_ = encoding::get_buffer_encoder<_Encoding, target_char_type>();
+    }
+
+    // reads the current string as a key, which is interned if an intern table is set
+    void get_key(typename value_type::string_type& out)
+    {
+        derived().get_string(out);
+        if (intern_table_)
+            intern(out, can_intern_strings{});
+    }
+
+    // parses another buffer with the same settings, the stream and the scratch buffers are reused
+    inline void reset(const source_char_type* first, const source_char_type* last)
+    {
+        buf_.reset(first, last);
+        is_.rdbuf(&buf_);
+        buffer_         = first;
+        buffer_end_     = last;
+        buffer_decoder_ = source_buffer_decoder_;
+    }
+
+protected:
+    inline _DerivedTy& derived()
+    {
+        return static_cast<_DerivedTy&>(*this);
+    }
+
+    // parses a value with an explicit stack of the arrays and objects being parsed
+    template <typename _HandlerTy>
+    bool do_sax_parse(_HandlerTy& handler, token_type token)
+    {
+        nesting_.clear();
+        while (true)
+        {
+            // the token begins a value
+            bool began = false;
+            switch (token)
+            {
+            case token_type::literal_true:
+                if (!handler.boolean(true))
+                    return false;
+                break;
+
+            case token_type::literal_false:
+                if (!handler.boolean(false))
+                    return false;
+                break;
+
+            case token_type::literal_null:
+                if (!handler.null())
+                    return false;
+                break;
+
+            case token_type::value_string:
+                string_buffer_.clear();
+                derived().get_string(string_buffer_);
+                if (!handler.string(string_buffer_))
+                    return false;
+                break;
+
+            case token_type::value_integer:
+            {
+                typename value_type::integer_type i{};
+                derived().get_integer(i);
+                if (!handler.integer(i))
+                    return false;
+                break;
+            }
+
+            case token_type::value_float:
+            {
+                typename value_type::float_type f{};
+                derived().get_float(f);
+                if (!handler.floating(f))
+                    return false;
+                break;
+            }
+
+            case token_type::begin_array:
+                enter(token);
+                if (!handler.start_array())
+                    return false;
+
+                token = derived().scan();
+                if (is_value_begin(token))
+                    continue;
+
+                began = true;
+                break;
+
+            case token_type::begin_object:
+                enter(token);
+                if (!handler.start_object())
+                    return false;
+
+                token = derived().scan();
+                if (token == token_type::value_string)
+                {
+                    if (!read_key(handler))
+                        return false;
+
+                    token = derived().scan();
+                    continue;
+                }
+
+                began = true;
+                break;
+
+            default:
+                fail(token);
+                break;
+            }
+
+            // the value is complete, close the arrays and objects until another value begins
+            while (true)
+            {
+                if (nesting_.empty())
+                    return true;
+
+                if (!began)
+                {
+                    // read ','
+                    token = derived().scan();
+                }
+
+                if (nesting_.back() == token_type::begin_array)
+                {
+                    if (!began && token == token_type::value_separator)
+                    {
+                        token = derived().scan();
+                        if (is_value_begin(token))
+                            break;
+                    }
+
+                    if (token != token_type::end_array)
+                        fail(token, token_type::end_array);
+
+                    nesting_.pop_back();
+                    if (!handler.end_array())
+                        return false;
+                }
+                else
+                {
+                    if (!began && token == token_type::value_separator)
+                    {
+                        token = derived().scan();
+                        if (token == token_type::value_string)
+                        {
+                            if (!read_key(handler))
+                                return false;
+
+                            token = derived().scan();
+                            break;
+                        }
+                    }
+
+                    if (token != token_type::end_object)
+                        fail(token, token_type::end_object);
+
+                    nesting_.pop_back();
+                    if (!handler.end_object())
+                        return false;
+                }
+                began = false;
+            }
+        }
+    }
+
+    // reads a key and the following ':'
+    template <typename _HandlerTy>
+    bool read_key(_HandlerTy& handler)
+    {
+        string_buffer_.clear();
+        get_key(string_buffer_);
+
+        if (!handler.key(string_buffer_))
+            return false;
+
+        const token_type token = derived().scan();
+        if (token != token_type::name_separator)
+            fail(token, token_type::end_object);
+        return true;
+    }
+
+    void enter(token_type token)
+    {
+        if (nesting_.size() >= max_depth_)
+            throw configor_deserialization_error("exceeded max depth");
+        nesting_.push_back(token);
+    }
+
+    static bool is_value_begin(token_type token)
+    {
+        switch (token)
+        {
+        case token_type::literal_true:
+        case token_type::literal_false:
+        case token_type::literal_null:
+        case token_type::value_string:
+        case token_type::value_integer:
+        case token_type::value_float:
+        case token_type::begin_array:
+        case token_type::begin_object:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void fail(token_type actual_token, const std::string& msg = "unexpected token")
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << to_string(actual_token) << "'";
+        throw configor_deserialization_error(ss.str());
+    }
+
+    void fail(token_type actual_token, token_type expected_token, const std::string& msg = "unexpected token")
+    {
+        fail(actual_token, msg + ", expect '" + to_string(expected_token) + "', but got");
+    }
+
+private:
+    template <typename _StrTy>
+    using assign_shared_fn = decltype(std::declval<_StrTy&>().assign_shared(
+        std::declval<typename basic_intern_table<target_char_type>::shared_type>()));
+
+    using can_intern_strings = is_detected<assign_shared_fn, typename value_type::string_type>;
+
+    void intern(typename value_type::string_type& str, std::true_type)
+    {
+        auto shared = intern_table_->intern(str.data(), str.size());
+        if (shared)
+            str.assign_shared(std::move(shared));
+    }
+
+    void intern(typename value_type::string_type&, std::false_type)
+    {
+    }
+
+    template <typename _Encoding>
+    static inline encoding::buffer_decoder<source_char_type> get_buffer_decoder(std::true_type)
+    {
+        return _Encoding::decode;
+    }
+
+    template <typename _Encoding>
+    static inline encoding::buffer_decoder<source_char_type> get_buffer_decoder(std::false_type)
+    {
+        // fallback to the stream decoder
+        return nullptr;
+    }
+
+protected:
+    std::basic_istream<source_char_type>       is_;
+    fast_range_istreambuf<source_char_type>    buf_;
+    const source_char_type*                    buffer_;
+    const source_char_type*                    buffer_end_;
+    error_handler*                             err_handler_;
+    encoding::decoder<source_char_type>        source_decoder_;
+    encoding::buffer_decoder<source_char_type> source_buffer_decoder_;
+    bool                                       source_utf8_;
+    encoding::buffer_decoder<source_char_type> buffer_decoder_;
+    encoding::buffer_encoder<target_char_type> target_encoder_;
+    typename value_type::string_type           string_buffer_;
+    std::size_t                                max_depth_;
+    std::vector<token_type>                    nesting_;
+    basic_intern_table<target_char_type>*      intern_table_;
+    basic_intern_table<target_char_type>       owned_intern_table_;
+};
+
+//
+// basic_parser with virtual functions
+//
+
+template <typename _ValTy, typename _SourceCharTy>
+class basic_parser<_ValTy, _SourceCharTy, void>
+    : public basic_parser<_ValTy, _SourceCharTy, basic_parser<_ValTy, _SourceCharTy, void>>
+{
+    friend class basic_parser<_ValTy, _SourceCharTy, basic_parser>;
+
+    using base_type = basic_parser<_ValTy, _SourceCharTy, basic_parser>;
+
+public:
+    using value_type       = _ValTy;
+    using source_char_type = _SourceCharTy;
+
+    basic_parser(std::basic_istream<source_char_type>& is)
+        : base_type(is)
+    {
+    }
+
+    basic_parser(const source_char_type* first, const source_char_type* last)
+        : base_type(first, last)
+    {
+    }
+
+    virtual void parse(value_type& c)
+    {
+        try
+        {
+            this->nesting_.clear();
+            do_parse(c, token_type::uninitialized);
+            if (scan() != token_type::end_of_input)
+                this->fail(token_type::end_of_input);
+        }
+        catch (...)
+        {
+            if (this->err_handler_)
+                this->err_handler_->handle(std::current_exception());
+            else
+                throw;
+        }
     }
 
 protected:
@@ -93,10 +489,11 @@ protected:
     virtual void get_float(typename value_type::float_type& out)     = 0;
     virtual void get_string(typename value_type::string_type& out)   = 0;
 
+    // parses a value, the elements of an array and the values of an object are parsed by do_parse too,
+    // so an override sees every value
+    // sax_parse does not call do_parse
     virtual void do_parse(value_type& c, token_type last_token, bool read_next = true)
     {
-        using string_type = typename _ValTy::string_type;
-
         token_type token = last_token;
         if (read_next)
         {
@@ -133,31 +530,15 @@ protected:
             break;
 
         case token_type::begin_array:
+            this->enter(token);
             c = value_constant::array;
             while (true)
             {
                 token = scan();
-
-                bool is_end = false;
-                switch (token)
-                {
-                case token_type::literal_true:
-                case token_type::literal_false:
-                case token_type::literal_null:
-                case token_type::value_string:
-                case token_type::value_integer:
-                case token_type::value_float:
-                case token_type::begin_array:
-                case token_type::begin_object:
-                    break;
-                default:
-                    is_end = true;
-                    break;
-                }
-                if (is_end)
+                if (!this->is_value_begin(token))
                     break;
 
-                c.data().vector->push_back(_ValTy());
+                c.data().vector->emplace_back();
                 do_parse(c.data().vector->back(), token, false);
 
                 // read ','
@@ -166,10 +547,12 @@ protected:
                     break;
             }
             if (token != token_type::end_array)
-                fail(token, token_type::end_array);
+                this->fail(token, token_type::end_array);
+            this->nesting_.pop_back();
             break;
 
         case token_type::begin_object:
+            this->enter(token);
             c = value_constant::object;
             while (true)
             {
@@ -177,16 +560,14 @@ protected:
                 if (token != token_type::value_string)
                     break;
 
-                string_type key{};
-                get_string(key);
+                // the key is interned like sax_parse does
+                key_reader reader;
+                this->read_key(reader);
 
-                token = scan();
-                if (token != token_type::name_separator)
-                    break;
-
-                _ValTy object;
-                do_parse(object, token);
-                c.data().object->emplace(key, object);
+                // the value of a duplicated key is parsed and dropped, the first one is kept
+                value_type member;
+                do_parse(member, token_type::name_separator);
+                c.data().object->emplace(std::move(reader.key_), std::move(member));
 
                 // read ','
                 token = scan();
@@ -194,39 +575,34 @@ protected:
                     break;
             }
             if (token != token_type::end_object)
-                fail(token, token_type::end_object);
+                this->fail(token, token_type::end_object);
+            this->nesting_.pop_back();
             break;
 
         default:
-            fail(token);
+            this->fail(token);
             break;
         }
     }
 
-    void fail(token_type actual_token, const std::string& msg = "unexpected token")
+private:
+    struct key_reader
     {
-        detail::fast_ostringstream ss;
-        ss << msg << " '" << to_string(actual_token) << "'";
-        throw configor_deserialization_error(ss.str());
-    }
-
-    void fail(token_type actual_token, token_type expected_token, const std::string& msg = "unexpected token")
-    {
-        fail(actual_token, msg + ", expect '" + to_string(expected_token) + "', but got");
-    }
+        typename value_type::string_type key_;
 
-protected:
-    std::basic_istream<source_char_type> is_;
-    error_handler*                       err_handler_;
-    encoding::decoder<source_char_type>  source_decoder_;
-    encoding::encoder<target_char_type>  target_encoder_;
+        bool key(typename value_type::string_type& s)
+        {
+            key_ = std::move(s);
+            return true;
+        }
+    };
 };
 
 //
 // parsable
 //
 
-template <typename _Args, template <class, class> class _ParserTy, template <class> class _DefaultEncoding>
+template <typename _Args, template <class, class, class...> class _ParserTy, template <class> class _DefaultEncoding>
 class parsable
 {
 public:
@@ -235,6 +611,10 @@ public:
     template <typename _SourceCharTy>
     using parser_type = _ParserTy<value_type, _SourceCharTy>;
 
+    // the parser with the traits of options given as types
+    template <typename _SourceCharTy, typename... _Opts>
+    using policy_parser_type = typename parser_type<_SourceCharTy>::template rebind_options<option_list<_Opts...>>;
+
     template <typename _SourceCharTy>
     using parser_option = typename parser_type<_SourceCharTy>::option;
 
@@ -244,10 +624,7 @@ public:
                       std::initializer_list<parser_option<_SourceCharTy>> options = {})
     {
         parser_type<_SourceCharTy> p{ is };
-        p.template set_source_encoding<_DefaultEncoding>();
-        p.template set_target_encoding<_DefaultEncoding>();
-        p.prepare(options);
-        p.parse(c);
+        parse(c, p, options);
     }
 
     template <typename _SourceCharTy>
@@ -264,18 +641,16 @@ public:
     static void parse(value_type& c, const typename _Args::template string_type<_SourceCharTy>& str,
                       std::initializer_list<parser_option<_SourceCharTy>> options = {})
     {
-        detail::fast_string_istreambuf<_SourceCharTy> buf{ str };
-        std::basic_istream<_SourceCharTy>             is{ &buf };
-        parse(c, is, options);
+        parse(c, str.data(), str.size(), options);
     }
 
     template <typename _SourceCharTy>
     static value_type parse(const typename _Args::template string_type<_SourceCharTy>& str,
                             std::initializer_list<parser_option<_SourceCharTy>>        options = {})
     {
-        detail::fast_string_istreambuf<_SourceCharTy> buf{ str };
-        std::basic_istream<_SourceCharTy>             is{ &buf };
-        return parse(is, options);
+        value_type c;
+        parse(c, str.data(), str.size(), options);
+        return c;
     }
 
     // parse from c-style string
@@ -283,17 +658,36 @@ public:
     static void parse(value_type& c, const _SourceCharTy* str,
                       std::initializer_list<parser_option<_SourceCharTy>> options = {})
     {
-        detail::fast_buffer_istreambuf<_SourceCharTy> buf{ str };
-        std::basic_istream<_SourceCharTy>             is{ &buf };
-        parse(c, is, options);
+        parse(c, str, std::char_traits<_SourceCharTy>::length(str), options);
     }
 
     template <typename _SourceCharTy>
     static value_type parse(const _SourceCharTy* str, std::initializer_list<parser_option<_SourceCharTy>> options = {})
     {
-        detail::fast_buffer_istreambuf<_SourceCharTy> buf{ str };
-        std::basic_istream<_SourceCharTy>             is{ &buf };
-        return parse(is, options);
+        value_type c;
+        parse(c, str, std::char_traits<_SourceCharTy>::length(str), options);
+        return c;
+    }
+
+    // parse from buffer
+    // the size is deduced so that `parse(str, {})` keeps selecting the overload with options
+    template <typename _SourceCharTy, typename _SizeTy,
+              typename = typename std::enable_if<std::is_integral<_SizeTy>::value>::type>
+    static void parse(value_type& c, const _SourceCharTy* buffer, _SizeTy size,
+                      std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        parser_type<_SourceCharTy> p{ buffer, buffer + static_cast<std::size_t>(size) };
+        parse(c, p, options);
+    }
+
+    template <typename _SourceCharTy, typename _SizeTy,
+              typename = typename std::enable_if<std::is_integral<_SizeTy>::value>::type>
+    static value_type parse(const _SourceCharTy* buffer, _SizeTy size,
+                            std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        value_type c;
+        parse(c, buffer, size, options);
+        return c;
     }
 
     // parse from c-style file
@@ -312,6 +706,173 @@ public:
         std::basic_istream<_SourceCharTy>            is{ &buf };
         return parse(is, options);
     }
+
+    // parse from file
+    // the file is memory mapped if possible and released once parsing finishes,
+    // so strings are always copied out of it
+    static void parse_file(value_type& c, const std::string& path,
+                           std::initializer_list<parser_option<char>> options = {})
+    {
+        file_buffer       file{ path };
+        parser_type<char> p{ file.data(), file.data() + file.size() };
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        p.prepare(options);
+        copy_strings(p, can_copy_strings<parser_type<char>>{});
+        p.parse(c);
+    }
+
+    static value_type parse_file(const std::string& path, std::initializer_list<parser_option<char>> options = {})
+    {
+        value_type c;
+        parse_file(c, path, options);
+        return c;
+    }
+
+    // sax parse from stream
+    template <typename _HandlerTy, typename _SourceCharTy>
+    static bool sax_parse(std::basic_istream<_SourceCharTy>& is, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        parser_type<_SourceCharTy> p{ is };
+        return sax_parse(p, handler, options);
+    }
+
+    // sax parse from string
+    template <typename _HandlerTy, typename _SourceCharTy>
+    static bool sax_parse(const typename _Args::template string_type<_SourceCharTy>& str, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>>        options = {})
+    {
+        return sax_parse(str.data(), str.size(), handler, options);
+    }
+
+    // sax parse from c-style string
+    template <typename _HandlerTy, typename _SourceCharTy>
+    static bool sax_parse(const _SourceCharTy* str, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        return sax_parse(str, std::char_traits<_SourceCharTy>::length(str), handler, options);
+    }
+
+    // sax parse from buffer
+    template <typename _HandlerTy, typename _SourceCharTy, typename _SizeTy,
+              typename = typename std::enable_if<std::is_integral<_SizeTy>::value>::type>
+    static bool sax_parse(const _SourceCharTy* buffer, _SizeTy size, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        parser_type<_SourceCharTy> p{ buffer, buffer + static_cast<std::size_t>(size) };
+        return sax_parse(p, handler, options);
+    }
+
+    // sax parse from c-style file
+    template <typename _HandlerTy, typename _SourceCharTy = typename value_type::char_type>
+    static bool sax_parse(std::FILE* file, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>> options = {})
+    {
+        detail::fast_cfile_istreambuf<_SourceCharTy> buf{ file };
+        std::basic_istream<_SourceCharTy>            is{ &buf };
+        return sax_parse(is, handler, options);
+    }
+
+    // sax parse from file
+    template <typename _HandlerTy>
+    static bool sax_parse_file(const std::string& path, _HandlerTy& handler,
+                               std::initializer_list<parser_option<char>> options = {})
+    {
+        file_buffer       file{ path };
+        parser_type<char> p{ file.data(), file.data() + file.size() };
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        p.prepare(options);
+        copy_strings(p, can_copy_strings<parser_type<char>>{});
+        return p.sax_parse(handler);
+    }
+
+    // parse with options given as types, which are fixed at compile time in the traits of the parser
+    // e.g. json::parse<json::opts::max_depth<64>, json::opts::utf8>(str)
+    template <typename _Opt, typename... _Opts, typename _SourceCharTy>
+    static typename std::enable_if<is_option<_Opt>::value, value_type>::type
+    parse(std::basic_istream<_SourceCharTy>& is)
+    {
+        policy_parser_type<_SourceCharTy, _Opt, _Opts...> p{ is };
+        return parse_with<option_list<_Opt, _Opts...>>(p);
+    }
+
+    template <typename _Opt, typename... _Opts, typename _SourceCharTy>
+    static typename std::enable_if<is_option<_Opt>::value, value_type>::type
+    parse(const typename _Args::template string_type<_SourceCharTy>& str)
+    {
+        policy_parser_type<_SourceCharTy, _Opt, _Opts...> p{ str.data(), str.data() + str.size() };
+        return parse_with<option_list<_Opt, _Opts...>>(p);
+    }
+
+    template <typename _Opt, typename... _Opts, typename _SourceCharTy>
+    static typename std::enable_if<is_option<_Opt>::value, value_type>::type
+    parse(const _SourceCharTy* str)
+    {
+        policy_parser_type<_SourceCharTy, _Opt, _Opts...> p{ str, str + std::char_traits<_SourceCharTy>::length(str) };
+        return parse_with<option_list<_Opt, _Opts...>>(p);
+    }
+
+    template <typename _Opt, typename... _Opts, typename _SourceCharTy, typename _SizeTy,
+              typename = typename std::enable_if<std::is_integral<_SizeTy>::value>::type>
+    static typename std::enable_if<is_option<_Opt>::value, value_type>::type
+    parse(const _SourceCharTy* buffer, _SizeTy size)
+    {
+        policy_parser_type<_SourceCharTy, _Opt, _Opts...> p{ buffer, buffer + static_cast<std::size_t>(size) };
+        return parse_with<option_list<_Opt, _Opts...>>(p);
+    }
+
+protected:
+    template <typename _PTy>
+    using set_insitu_strings_fn = decltype(std::declval<_PTy&>().set_insitu_strings(false));
+
+    template <typename _PTy>
+    using can_copy_strings = is_detected<set_insitu_strings_fn, _PTy>;
+
+    // strings must not refer to a buffer released before the value
+    template <typename _PTy>
+    static void copy_strings(_PTy& p, std::true_type)
+    {
+        p.set_insitu_strings(false);
+    }
+
+    template <typename _PTy>
+    static void copy_strings(_PTy&, std::false_type)
+    {
+    }
+
+    template <typename _OptionsTy, typename _PolicyParserTy>
+    static value_type parse_with(_PolicyParserTy& p)
+    {
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        _OptionsTy::apply_parser(p);
+
+        value_type c;
+        p.parse(c);
+        return c;
+    }
+
+    template <typename _SourceCharTy>
+    static void parse(value_type& c, parser_type<_SourceCharTy>& p,
+                      std::initializer_list<parser_option<_SourceCharTy>> options)
+    {
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        p.prepare(options);
+        p.parse(c);
+    }
+
+    template <typename _HandlerTy, typename _SourceCharTy>
+    static bool sax_parse(parser_type<_SourceCharTy>& p, _HandlerTy& handler,
+                          std::initializer_list<parser_option<_SourceCharTy>> options)
+    {
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        p.prepare(options);
+        return p.sax_parse(handler);
+    }
 };
 
 }  // namespace detail
@@ -0,0 +1,257 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "value.hpp"
+
+#include <type_traits>  // std::true_type, std::false_type
+#include <utility>      // std::move, std::declval
+#include <vector>       // std::vector
+
+namespace configor
+{
+
+//
+// sax handler
+// receives the events of a parser, parsing stops as soon as an event returns false
+//
+// string and key events pass a buffer of the parser, which may be moved from
+// but is only valid until the event returns
+//
+// parsers accept any type with the same member functions, deriving from
+// basic_sax_handler is optional
+//
+
+template <typename _ValTy>
+class basic_sax_handler
+{
+public:
+    using value_type   = _ValTy;
+    using integer_type = typename value_type::integer_type;
+    using float_type   = typename value_type::float_type;
+    using string_type  = typename value_type::string_type;
+
+    virtual ~basic_sax_handler() = default;
+
+    virtual bool null()                  = 0;
+    virtual bool boolean(bool b)         = 0;
+    virtual bool integer(integer_type i) = 0;
+    virtual bool floating(float_type f)  = 0;
+    virtual bool string(string_type& s)  = 0;
+    virtual bool start_object()          = 0;
+    virtual bool key(string_type& s)     = 0;
+    virtual bool end_object()            = 0;
+    virtual bool start_array()           = 0;
+    virtual bool end_array()             = 0;
+};
+
+namespace detail
+{
+
+//
+// value_builder
+// builds a basic_value from sax events
+//
+
+template <typename _ValTy>
+class value_builder final : public basic_sax_handler<_ValTy>
+{
+public:
+    using value_type   = _ValTy;
+    using integer_type = typename value_type::integer_type;
+    using float_type   = typename value_type::float_type;
+    using string_type  = typename value_type::string_type;
+    using object_type  = typename value_type::object_type;
+
+    explicit value_builder(value_type& root)
+        : root_(root)
+        , stack_()
+        , slot_(nullptr)
+        , skip_depth_(0)
+    {
+    }
+
+    virtual bool null() override
+    {
+        if (!skip(0))
+            next() = value_constant::null;
+        return true;
+    }
+
+    virtual bool boolean(bool b) override
+    {
+        if (!skip(0))
+            next() = b;
+        return true;
+    }
+
+    virtual bool integer(integer_type i) override
+    {
+        if (!skip(0))
+        {
+            value_type& v    = next();
+            v                = value_constant::integer;
+            v.data().integer = i;
+        }
+        return true;
+    }
+
+    virtual bool floating(float_type f) override
+    {
+        if (!skip(0))
+        {
+            value_type& v     = next();
+            v                 = value_constant::floating;
+            v.data().floating = f;
+        }
+        return true;
+    }
+
+    virtual bool string(string_type& s) override
+    {
+        if (!skip(0))
+        {
+            value_type& v    = next();
+            v                = value_constant::string;
+            *v.data().string = std::move(s);
+        }
+        return true;
+    }
+
+    virtual bool start_object() override
+    {
+        if (!skip(1))
+        {
+            value_type& v = next();
+            v             = value_constant::object;
+            stack_.push_back(&v);
+        }
+        return true;
+    }
+
+    virtual bool key(string_type& s) override
+    {
+        if (skip_depth_ == 0)
+        {
+            CONFIGOR_ASSERT(!stack_.empty() && stack_.back()->is_object());
+
+            slot_ = emplace(*stack_.back()->data().object, s, can_append_sorted{});
+            if (slot_ == nullptr)
+            {
+                // the value of a duplicated key is skipped, the first one is kept
+                skip_depth_ = 1;
+            }
+        }
+        return true;
+    }
+
+    virtual bool end_object() override
+    {
+        if (!skip(-1))
+            stack_.pop_back();
+        return true;
+    }
+
+    virtual bool start_array() override
+    {
+        if (!skip(1))
+        {
+            value_type& v = next();
+            v             = value_constant::array;
+            stack_.push_back(&v);
+        }
+        return true;
+    }
+
+    virtual bool end_array() override
+    {
+        if (!skip(-1))
+            stack_.pop_back();
+        return true;
+    }
+
+private:
+    value_type& next()
+    {
+        if (slot_ != nullptr)
+        {
+            value_type& v = *slot_;
+            slot_         = nullptr;
+            return v;
+        }
+
+        if (stack_.empty())
+            return root_;
+
+        CONFIGOR_ASSERT(stack_.back()->is_array());
+
+        auto& vector = *stack_.back()->data().vector;
+        vector.emplace_back();
+        return vector.back();
+    }
+
+    template <typename _ObjTy>
+    using append_sorted_fn = decltype(std::declval<_ObjTy&>().emplace_hint(std::declval<_ObjTy&>().end(),
+                                                                            std::declval<string_type>(), value_type()),
+                                      std::declval<_ObjTy&>().key_comp()(std::declval<_ObjTy&>().rbegin()->first,
+                                                                         std::declval<string_type&>()));
+
+    using can_append_sorted = is_detected<append_sorted_fn, object_type>;
+
+    // returns nullptr if the key exists
+    static value_type* emplace(object_type& object, string_type& key, std::true_type)
+    {
+        if (!object.empty() && object.key_comp()(object.rbegin()->first, key))
+        {
+            // keys in sorted order are appended without searching
+            return &object.emplace_hint(object.end(), std::move(key), value_type())->second;
+        }
+        return emplace(object, key, std::false_type{});
+    }
+
+    static value_type* emplace(object_type& object, string_type& key, std::false_type)
+    {
+        auto result = object.emplace(std::move(key), value_type());
+        return result.second ? &result.first->second : nullptr;
+    }
+
+    // returns true if the event belongs to a skipped value
+    // skip_depth_ is 1 for the skipped value itself, and increases with its nested values
+    bool skip(int delta)
+    {
+        if (skip_depth_ == 0)
+            return false;
+
+        skip_depth_ += delta;
+        if (skip_depth_ == 1 && delta <= 0)
+            skip_depth_ = 0;
+        return true;
+    }
+
+private:
+    value_type&              root_;
+    std::vector<value_type*> stack_;
+    value_type*              slot_;
+    int                      skip_depth_;
+};
+
+}  // namespace detail
+
+}  // namespace configor
@@ -19,7 +19,9 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "conversion.hpp"
 #include "encoding.hpp"
+#include "format.hpp"
 #include "stream.hpp"
 #include "token.hpp"
 #include "value.hpp"
@@ -29,6 +31,11 @@
 #include <ios>               // std::streamsize
 #include <locale>            // std::locale
 #include <ostream>           // std::basic_ostream
+#include <streambuf>         // std::basic_streambuf
+#include <string>            // std::basic_string
+#include <type_traits>       // std::integral_constant, std::is_default_constructible
+#include <utility>           // std::declval
+#include <vector>            // std::vector
 
 namespace configor
 {
@@ -36,7 +43,9 @@ namespace configor
 namespace detail
 {
 
-template <typename _ValTy, typename _TargetCharTy>
+// the tokens are written through _DerivedTy without virtual calls,
+// see the specialization below for serializers which implement them with virtual functions
+template <typename _ValTy, typename _TargetCharTy, typename _DerivedTy = void>
 class basic_serializer
 {
 public:
@@ -49,17 +58,37 @@ public:
         , err_handler_(nullptr)
         , source_decoder_(nullptr)
         , target_encoder_(nullptr)
+        , source_utf8_(false)
+        , target_utf8_(false)
     {
         os_.setf(os.flags(), std::ios_base::floatfield);
         os_.imbue(std::locale(std::locale::classic(), os.getloc(), std::locale::collate | std::locale::ctype));
     }
 
-    virtual void dump(const value_type& c)
+    void dump(const value_type& c)
+    {
+        try
+        {
+            derived().do_dump(c);
+            derived().next(token_type::end_of_input);
+        }
+        catch (...)
+        {
+            if (err_handler_)
+                err_handler_->handle(std::current_exception());
+            else
+                throw;
+        }
+    }
+
+    // dumps a type bound by CONFIGOR_BIND without converting it to a value
+    template <typename _Ty>
+    void dump_bound(const _Ty& v)
     {
         try
         {
-            do_dump(c);
-            next(token_type::end_of_input);
+            write(v, priority<1>{});
+            derived().next(token_type::end_of_input);
         }
         catch (...)
         {
@@ -79,22 +108,29 @@ public:
     inline void set_source_encoding()
     {
         source_decoder_ = _Encoding<source_char_type>::decode;
+        source_utf8_    = encoding::is_utf8_encoding<_Encoding<source_char_type>>::value;
     }
 
     template <template <class> class _Encoding>
     inline void set_target_encoding()
     {
         target_encoder_ = _Encoding<target_char_type>::encode;
+        target_utf8_    = encoding::is_utf8_encoding<_Encoding<target_char_type>>::value;
     }
 
-protected:
-    virtual void next(token_type t) = 0;
+    // writes to another buffer with the same settings, the stream and the escaped keys are reused
+    inline void reset(std::basic_streambuf<target_char_type>* buf)
+    {
+        os_.rdbuf(buf);
+    }
 
-    virtual void put_integer(typename value_type::integer_type i)      = 0;
-    virtual void put_float(typename value_type::float_type f)          = 0;
-    virtual void put_string(const typename value_type::string_type& s) = 0;
+protected:
+    inline _DerivedTy& derived()
+    {
+        return static_cast<_DerivedTy&>(*this);
+    }
 
-    virtual void do_dump(const value_type& c)
+    void do_dump(const value_type& c)
     {
         switch (c.type())
         {
@@ -102,10 +138,10 @@ protected:
         {
             const auto& object = *c.data().object;
 
-            next(token_type::begin_object);
+            derived().next(token_type::begin_object);
             if (object.empty())
             {
-                next(token_type::end_object);
+                derived().next(token_type::end_object);
                 return;
             }
 
@@ -113,51 +149,51 @@ protected:
             auto size = object.size();
             for (std::size_t i = 0; i < size; ++i, ++iter)
             {
-                next(token_type::value_string);
-                put_string(iter->first);
-                next(token_type::name_separator);
+                derived().next(token_type::value_string);
+                derived().put_string(iter->first);
+                derived().next(token_type::name_separator);
 
-                do_dump(iter->second);
+                derived().do_dump(iter->second);
 
                 // not last element
                 if (i != size - 1)
                 {
-                    next(token_type::value_separator);
+                    derived().next(token_type::value_separator);
                 }
             }
-            next(token_type::end_object);
+            derived().next(token_type::end_object);
             return;
         }
 
         case value_constant::array:
         {
-            next(token_type::begin_array);
+            derived().next(token_type::begin_array);
 
             auto& v = *c.data().vector;
             if (v.empty())
             {
-                next(token_type::end_array);
+                derived().next(token_type::end_array);
                 return;
             }
 
             const auto size = v.size();
             for (std::size_t i = 0; i < size; ++i)
             {
-                do_dump(v.at(i));
+                derived().do_dump(v.at(i));
                 // not last element
                 if (i != size - 1)
                 {
-                    next(token_type::value_separator);
+                    derived().next(token_type::value_separator);
                 }
             }
-            next(token_type::end_array);
+            derived().next(token_type::end_array);
             return;
         }
 
         case value_constant::string:
         {
-            next(token_type::value_string);
-            put_string(*c.data().string);
+            derived().next(token_type::value_string);
+            derived().put_string(*c.data().string);
             return;
         }
 
@@ -165,49 +201,286 @@ protected:
         {
             if (c.data().boolean)
             {
-                next(token_type::literal_true);
+                derived().next(token_type::literal_true);
             }
             else
             {
-                next(token_type::literal_false);
+                derived().next(token_type::literal_false);
             }
             return;
         }
 
         case value_constant::integer:
         {
-            next(token_type::value_integer);
-            put_integer(c.data().integer);
+            derived().next(token_type::value_integer);
+            derived().put_integer(c.data().integer);
             return;
         }
 
         case value_constant::floating:
         {
-            next(token_type::value_float);
-            put_float(c.data().floating);
+            derived().next(token_type::value_float);
+            derived().put_float(c.data().floating);
             return;
         }
 
         case value_constant::null:
         {
-            next(token_type::literal_null);
+            derived().next(token_type::literal_null);
             return;
         }
         }
     }
 
+    // writes the fields in the same order and with the same omissions as the value converted by to_value
+    template <typename _Ty, typename std::enable_if<has_field_table<value_type, _Ty>::value, int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        const auto& table = field_table<value_type, _Ty>::get(v);
+
+        field_collector fields;
+        configor_visit_fields(static_cast<const value_type*>(nullptr), const_cast<_Ty&>(v), fields);
+        if (!fields.direct)
+        {
+            // an optional field can not be compared with its default value
+            derived().do_dump(value_type(v));
+            return;
+        }
+
+        if (fields.written == 0)
+        {
+            // no field is converted
+            derived().next(token_type::literal_null);
+            return;
+        }
+
+        // the keys are written by put_string unless the derived serializer writes literals
+        const std::vector<key_literal>* literals = derived().writes_key_literals() ? &key_literals(table) : nullptr;
+
+        derived().next(token_type::begin_object);
+        bool first = true;
+        for (const auto i : table.object_order())
+        {
+            const field_ref& field = fields.refs[i];
+            if (!field.ptr)
+                continue;
+
+            if (!first)
+                derived().next(token_type::value_separator);
+            first = false;
+
+            derived().next(token_type::value_string);
+            if (literals && !(*literals)[i].empty())
+                os_.write((*literals)[i].data(), static_cast<std::streamsize>((*literals)[i].size()));
+            else
+                derived().put_string(table.name(i));
+            derived().next(token_type::name_separator);
+
+            field.write(*this, field.ptr);
+        }
+        derived().next(token_type::end_object);
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_same<_Ty, value_type>::value, int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        derived().do_dump(v);
+    }
+
+    template <typename _Ty,
+              typename std::enable_if<std::is_same<_Ty, typename value_type::boolean_type>::value, int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        derived().next(v ? token_type::literal_true : token_type::literal_false);
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_integral<_Ty>::value
+                                                        && !std::is_same<_Ty, typename value_type::boolean_type>::value,
+                                                    int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        derived().next(token_type::value_integer);
+        derived().put_integer(static_cast<typename value_type::integer_type>(v));
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_floating_point<_Ty>::value, int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        derived().next(token_type::value_float);
+        derived().put_float(static_cast<typename value_type::float_type>(v));
+    }
+
+    template <typename _Ty,
+              typename std::enable_if<std::is_same<_Ty, typename value_type::string_type>::value, int>::type = 0>
+    void write(const _Ty& v, priority<1>)
+    {
+        derived().next(token_type::value_string);
+        derived().put_string(v);
+    }
+
+    template <typename _Ty>
+    void write(const std::vector<_Ty>& v, priority<1>)
+    {
+        derived().next(token_type::begin_array);
+        for (std::size_t i = 0; i < v.size(); ++i)
+        {
+            if (i != 0)
+                derived().next(token_type::value_separator);
+            write(static_cast<const _Ty&>(v[i]), priority<1>{});
+        }
+        derived().next(token_type::end_array);
+    }
+
+    template <typename _Ty>
+    void write(const _Ty& v, priority<0>)
+    {
+        derived().do_dump(value_type(v));
+    }
+
+private:
+    struct field_ref
+    {
+        const void* ptr;
+        void (*write)(basic_serializer&, const void*);
+    };
+
+    // an optional field is omitted if it equals its default value, like the value converted by to_value
+    template <typename _FieldTy>
+    using not_equal_fn = decltype(std::declval<const _FieldTy&>() != std::declval<const _FieldTy&>());
+
+    template <typename _FieldTy>
+    using is_omittable_field = std::integral_constant<bool, std::is_default_constructible<_FieldTy>::value
+                                                                && is_detected<not_equal_fn, _FieldTy>::value>;
+
+    struct field_collector
+    {
+        field_ref   refs[max_bound_fields];
+        std::size_t size    = 0;
+        std::size_t written = 0;
+        bool        direct  = true;
+
+        template <typename _CharTy, typename _FieldTy>
+        void operator()(const _CharTy*, _FieldTy& field, std::true_type)
+        {
+            field_ref& ref = refs[size++];
+            ref.ptr        = &field;
+            ref.write      = &write_field<_FieldTy>;
+            ++written;
+        }
+
+        template <typename _CharTy, typename _FieldTy,
+                  typename std::enable_if<is_omittable_field<_FieldTy>::value, int>::type = 0>
+        void operator()(const _CharTy* name, _FieldTy& field, std::false_type)
+        {
+            if (field != _FieldTy{})
+                (*this)(name, field, std::true_type{});
+            else
+                refs[size++].ptr = nullptr;
+        }
+
+        template <typename _CharTy, typename _FieldTy,
+                  typename std::enable_if<!is_omittable_field<_FieldTy>::value, int>::type = 0>
+        void operator()(const _CharTy*, _FieldTy&, std::false_type)
+        {
+            refs[size++].ptr = nullptr;
+            direct           = false;
+        }
+    };
+
+    template <typename _FieldTy>
+    static void write_field(basic_serializer& s, const void* field)
+    {
+        s.write(*static_cast<const _FieldTy*>(field), priority<1>{});
+    }
+
+    // the literals of the keys of a bound type are built once and shared by all serializers
+    // a key is empty if it depends on the options and is written by put_string instead
+    using key_literal = std::basic_string<target_char_type>;
+
+    template <typename _Ty>
+    static const std::vector<key_literal>& key_literals(const field_table<value_type, _Ty>& table)
+    {
+        static const std::vector<key_literal> literals = make_key_literals(table);
+        return literals;
+    }
+
+    template <typename _Ty>
+    static std::vector<key_literal> make_key_literals(const field_table<value_type, _Ty>& table)
+    {
+        std::vector<key_literal> literals(table.size());
+        for (std::size_t i = 0; i < table.size(); ++i)
+        {
+            if (!_DerivedTy::make_key_literal(table.name(i), literals[i]))
+                literals[i].clear();
+        }
+        return literals;
+    }
+
+    // no key is written the same way with every option unless the derived serializer knows the format
+    static bool make_key_literal(const typename value_type::string_type&, key_literal&)
+    {
+        return false;
+    }
+
+    // a derived serializer that writes strings its own way, like one with virtual functions, never writes literals
+    bool writes_key_literals() const
+    {
+        return false;
+    }
+
 protected:
     std::basic_ostream<target_char_type> os_;
     error_handler*                       err_handler_;
     encoding::decoder<source_char_type>  source_decoder_;
     encoding::encoder<target_char_type>  target_encoder_;
+    bool                                 source_utf8_;
+    bool                                 target_utf8_;
+};
+
+//
+// basic_serializer with virtual functions
+//
+
+template <typename _ValTy, typename _TargetCharTy>
+class basic_serializer<_ValTy, _TargetCharTy, void>
+    : public basic_serializer<_ValTy, _TargetCharTy, basic_serializer<_ValTy, _TargetCharTy, void>>
+{
+    friend class basic_serializer<_ValTy, _TargetCharTy, basic_serializer>;
+
+    using base_type = basic_serializer<_ValTy, _TargetCharTy, basic_serializer>;
+
+public:
+    using value_type       = _ValTy;
+    using target_char_type = _TargetCharTy;
+
+    explicit basic_serializer(std::basic_ostream<target_char_type>& os)
+        : base_type(os)
+    {
+    }
+
+    virtual void dump(const value_type& c)
+    {
+        base_type::dump(c);
+    }
+
+protected:
+    virtual void next(token_type t) = 0;
+
+    virtual void put_integer(typename value_type::integer_type i)      = 0;
+    virtual void put_float(typename value_type::float_type f)          = 0;
+    virtual void put_string(const typename value_type::string_type& s) = 0;
+
+    virtual void do_dump(const value_type& c)
+    {
+        base_type::do_dump(c);
+    }
 };
 
 //
 // serializable
 //
 
-template <class _Args, template <class, class> class _SerializerTy, template <class> class _DefaultEncoding>
+template <class _Args, template <class, class, class...> class _SerializerTy, template <class> class _DefaultEncoding>
 class serializable
 {
 public:
@@ -216,6 +489,11 @@ public:
     template <typename _TargetCharTy>
     using serializer_type = _SerializerTy<value_type, _TargetCharTy>;
 
+    // the serializer with the traits of options given as types
+    template <typename _TargetCharTy, typename... _Opts>
+    using policy_serializer_type =
+        typename serializer_type<_TargetCharTy>::template rebind_options<option_list<_Opts...>>;
+
     template <typename _TargetCharTy>
     using serializer_option = typename serializer_type<_TargetCharTy>::option;
 
@@ -236,19 +514,87 @@ public:
     static void dump(typename _Args::template string_type<_TargetCharTy>& str, const value_type& v,
                      std::initializer_list<serializer_option<_TargetCharTy>> options = {})
     {
-        detail::fast_string_ostreambuf<_TargetCharTy> buf{ str };
-        std::basic_ostream<_TargetCharTy>             os{ &buf };
+        using string_type = typename _Args::template string_type<_TargetCharTy>;
+
+        detail::fast_string_ostreambuf<_TargetCharTy, string_type> buf{ str };
+        std::basic_ostream<_TargetCharTy>                          os{ &buf };
         return dump<_TargetCharTy>(os, v, options);
     }
 
     template <typename _TargetCharTy = typename value_type::char_type>
-    static typename _Args::template string_type<_TargetCharTy>
+    static typename std::enable_if<std::is_integral<_TargetCharTy>::value,
+                                   typename _Args::template string_type<_TargetCharTy>>::type
     dump(const value_type& v, std::initializer_list<serializer_option<_TargetCharTy>> options = {})
     {
         typename _Args::template string_type<_TargetCharTy> result;
         dump<_TargetCharTy>(result, v, options);
         return result;
     }
+
+    // dump with options given as types, which are fixed at compile time in the traits of the serializer
+    // e.g. json::dump<json::opts::indent<4>>(v)
+    template <typename _Opt, typename... _Opts, typename _TargetCharTy>
+    static typename std::enable_if<is_option<_Opt>::value>::type
+    dump(std::basic_ostream<_TargetCharTy>& os, const value_type& v)
+    {
+        policy_serializer_type<_TargetCharTy, _Opt, _Opts...> s{ os };
+        s.template set_source_encoding<_DefaultEncoding>();
+        s.template set_target_encoding<_DefaultEncoding>();
+        option_list<_Opt, _Opts...>::apply_serializer(s);
+        s.prepare({});
+        s.dump(v);
+    }
+
+    template <typename _Opt, typename... _Opts>
+    static typename std::enable_if<is_option<_Opt>::value,
+                                   typename _Args::template string_type<typename value_type::char_type>>::type
+    dump(const value_type& v)
+    {
+        using char_type   = typename value_type::char_type;
+        using string_type = typename _Args::template string_type<char_type>;
+
+        string_type                                            result;
+        detail::fast_string_ostreambuf<char_type, string_type> buf{ result };
+        std::basic_ostream<char_type>                          os{ &buf };
+        dump<_Opt, _Opts...>(os, v);
+        return result;
+    }
+
+    // dump types bound by CONFIGOR_BIND without converting them to a value
+
+    template <typename _TargetCharTy, typename _Ty,
+              typename = typename std::enable_if<has_field_table<value_type, _Ty>::value>::type>
+    static void dump(std::basic_ostream<_TargetCharTy>& os, const _Ty& v,
+                     std::initializer_list<serializer_option<_TargetCharTy>> options = {})
+    {
+        serializer_type<_TargetCharTy> s{ os };
+        s.template set_source_encoding<_DefaultEncoding>();
+        s.template set_target_encoding<_DefaultEncoding>();
+        s.prepare(options);
+        s.dump_bound(v);
+    }
+
+    template <typename _TargetCharTy, typename _Ty,
+              typename = typename std::enable_if<has_field_table<value_type, _Ty>::value>::type>
+    static void dump(typename _Args::template string_type<_TargetCharTy>& str, const _Ty& v,
+                     std::initializer_list<serializer_option<_TargetCharTy>> options = {})
+    {
+        using string_type = typename _Args::template string_type<_TargetCharTy>;
+
+        detail::fast_string_ostreambuf<_TargetCharTy, string_type> buf{ str };
+        std::basic_ostream<_TargetCharTy>                          os{ &buf };
+        return dump<_TargetCharTy>(os, v, options);
+    }
+
+    template <typename _TargetCharTy = typename value_type::char_type, typename _Ty,
+              typename = typename std::enable_if<has_field_table<value_type, _Ty>::value>::type>
+    static typename _Args::template string_type<_TargetCharTy>
+    dump(const _Ty& v, std::initializer_list<serializer_option<_TargetCharTy>> options = {})
+    {
+        typename _Args::template string_type<_TargetCharTy> result;
+        dump<_TargetCharTy>(result, v, options);
+        return result;
+    }
 };
 
 //
@@ -282,6 +628,11 @@ public:
         --depth_;
     }
 
+    inline void reset()
+    {
+        depth_ = 0;
+    }
+
     inline void put(std::basic_ostream<char_type>& os) const
     {
         os.write(indent_string_.c_str(), static_cast<std::streamsize>(depth_ * step_));
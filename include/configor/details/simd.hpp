@@ -0,0 +1,548 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "exception.hpp"
+
+#include <cstddef>      // std::size_t
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstring>      // std::memchr, std::memcpy
+#include <type_traits>  // std::integral_constant, std::make_unsigned
+
+// Define CONFIGOR_DISABLE_SIMD to always use the scalar implementations
+#ifndef CONFIGOR_DISABLE_SIMD
+#if defined(__AVX2__)
+#define __CONFIGOR_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define __CONFIGOR_SSE2
+#endif
+#endif
+
+#if defined(__CONFIGOR_AVX2)
+#include <immintrin.h>
+#elif defined(__CONFIGOR_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>  // _BitScanForward
+#endif
+
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define __CONFIGOR_LITTLE_ENDIAN
+#endif
+
+namespace configor
+{
+
+namespace detail
+{
+
+namespace simd
+{
+
+inline uint32_t count_trailing_zeros(uint32_t mask)
+{
+    CONFIGOR_ASSERT(mask != 0);
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+inline uint32_t count_trailing_zeros(uint64_t mask)
+{
+    CONFIGOR_ASSERT(mask != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return static_cast<uint32_t>(index);
+#elif defined(_MSC_VER)
+    const uint32_t low = static_cast<uint32_t>(mask);
+    return low ? count_trailing_zeros(low) : 32 + count_trailing_zeros(static_cast<uint32_t>(mask >> 32));
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+template <typename _CharTy>
+inline bool is_whitespace(_CharTy ch)
+{
+    return ch == _CharTy(' ') || ch == _CharTy('\t') || ch == _CharTy('\n') || ch == _CharTy('\r');
+}
+
+//
+// skip_whitespace
+// returns the first character in [first, last) which is not a JSON whitespace
+//
+
+template <typename _CharTy>
+inline const _CharTy* skip_whitespace(const _CharTy* first, const _CharTy* last, std::false_type)
+{
+    while (first != last && is_whitespace(*first))
+        ++first;
+    return first;
+}
+
+template <typename _CharTy>
+inline const _CharTy* skip_whitespace(const _CharTy* first, const _CharTy* last, std::true_type)
+{
+#if defined(__CONFIGOR_AVX2)
+    const __m256i spaces32 = _mm256_set1_epi8(' ');
+    const __m256i tabs32   = _mm256_set1_epi8('\t');
+    const __m256i lfs32    = _mm256_set1_epi8('\n');
+    const __m256i crs32    = _mm256_set1_epi8('\r');
+    while (last - first >= 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const __m256i ws    = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, spaces32), _mm256_cmpeq_epi8(chunk, tabs32)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lfs32), _mm256_cmpeq_epi8(chunk, crs32)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 32;
+    }
+#endif
+#if defined(__CONFIGOR_SSE2) || defined(__CONFIGOR_AVX2)
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i tabs   = _mm_set1_epi8('\t');
+    const __m128i lfs    = _mm_set1_epi8('\n');
+    const __m128i crs    = _mm_set1_epi8('\r');
+    while (last - first >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i ws    = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, tabs)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, lfs), _mm_cmpeq_epi8(chunk, crs)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFF;
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 16;
+    }
+#endif
+    return skip_whitespace(first, last, std::false_type{});
+}
+
+template <typename _CharTy>
+inline const _CharTy* skip_whitespace(const _CharTy* first, const _CharTy* last)
+{
+    return skip_whitespace(first, last, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// find
+// returns the first position of ch in [first, last), or last if not found
+//
+
+template <typename _CharTy>
+inline const _CharTy* find(const _CharTy* first, const _CharTy* last, _CharTy ch, std::false_type)
+{
+    while (first != last && *first != ch)
+        ++first;
+    return first;
+}
+
+template <typename _CharTy>
+inline const _CharTy* find(const _CharTy* first, const _CharTy* last, _CharTy ch, std::true_type)
+{
+    // std::memchr is vectorized by every mainstream C runtime
+    const void* pos = std::memchr(first, static_cast<unsigned char>(ch), static_cast<std::size_t>(last - first));
+    return pos ? static_cast<const _CharTy*>(pos) : last;
+}
+
+template <typename _CharTy>
+inline const _CharTy* find(const _CharTy* first, const _CharTy* last, _CharTy ch)
+{
+    return find(first, last, ch, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// find_first_of
+// returns the first position of ch1 or ch2 in [first, last), or last if not found
+//
+
+template <typename _CharTy>
+inline const _CharTy* find_first_of(const _CharTy* first, const _CharTy* last, _CharTy ch1, _CharTy ch2,
+                                    std::false_type)
+{
+    while (first != last && *first != ch1 && *first != ch2)
+        ++first;
+    return first;
+}
+
+template <typename _CharTy>
+inline const _CharTy* find_first_of(const _CharTy* first, const _CharTy* last, _CharTy ch1, _CharTy ch2,
+                                    std::true_type)
+{
+#if defined(__CONFIGOR_AVX2)
+    const __m256i needle1_32 = _mm256_set1_epi8(static_cast<char>(ch1));
+    const __m256i needle2_32 = _mm256_set1_epi8(static_cast<char>(ch2));
+    while (last - first >= 32)
+    {
+        const __m256i  chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const uint32_t mask  = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, needle1_32), _mm256_cmpeq_epi8(chunk, needle2_32))));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 32;
+    }
+#endif
+#if defined(__CONFIGOR_SSE2) || defined(__CONFIGOR_AVX2)
+    const __m128i needle1 = _mm_set1_epi8(static_cast<char>(ch1));
+    const __m128i needle2 = _mm_set1_epi8(static_cast<char>(ch2));
+    while (last - first >= 16)
+    {
+        const __m128i  chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const uint32_t mask  = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, needle1), _mm_cmpeq_epi8(chunk, needle2))));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 16;
+    }
+#endif
+    return find_first_of(first, last, ch1, ch2, std::false_type{});
+}
+
+template <typename _CharTy>
+inline const _CharTy* find_first_of(const _CharTy* first, const _CharTy* last, _CharTy ch1, _CharTy ch2)
+{
+    return find_first_of(first, last, ch1, ch2, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// skip_plain_string
+// returns the first character in [first, last) which is a quote, a backslash, a control character or not ascii
+//
+
+template <typename _CharTy>
+inline bool is_plain_string_char(_CharTy ch)
+{
+    const auto code = static_cast<uint32_t>(static_cast<typename std::make_unsigned<_CharTy>::type>(ch));
+    return code >= 0x20 && code < 0x80 && code != '\"' && code != '\\';
+}
+
+template <typename _CharTy>
+inline const _CharTy* skip_plain_string(const _CharTy* first, const _CharTy* last, std::false_type)
+{
+    while (first != last && is_plain_string_char(*first))
+        ++first;
+    return first;
+}
+
+template <typename _CharTy>
+inline const _CharTy* skip_plain_string(const _CharTy* first, const _CharTy* last, std::true_type)
+{
+    // a signed comparison with 0x20 matches both control characters and non-ascii bytes
+#if defined(__CONFIGOR_AVX2)
+    const __m256i quotes32      = _mm256_set1_epi8('"');
+    const __m256i backslashes32 = _mm256_set1_epi8('\\');
+    const __m256i controls32    = _mm256_set1_epi8(0x20);
+    while (last - first >= 32)
+    {
+        const __m256i chunk   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quotes32), _mm256_cmpeq_epi8(chunk, backslashes32)),
+            _mm256_cmpgt_epi8(controls32, chunk));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 32;
+    }
+#endif
+#if defined(__CONFIGOR_SSE2) || defined(__CONFIGOR_AVX2)
+    const __m128i quotes      = _mm_set1_epi8('"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i controls    = _mm_set1_epi8(0x20);
+    while (last - first >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i special =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, backslashes)),
+                         _mm_cmplt_epi8(chunk, controls));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 16;
+    }
+#endif
+    return skip_plain_string(first, last, std::false_type{});
+}
+
+template <typename _CharTy>
+inline const _CharTy* skip_plain_string(const _CharTy* first, const _CharTy* last)
+{
+    return skip_plain_string(first, last, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// find_nesting_char
+// returns the first quote, bracket, brace or slash in [first, last), or last if not found
+//
+
+template <typename _CharTy>
+inline bool is_nesting_char(_CharTy ch)
+{
+    return ch == _CharTy('"') || ch == _CharTy('[') || ch == _CharTy(']') || ch == _CharTy('{') || ch == _CharTy('}')
+           || ch == _CharTy('/');
+}
+
+template <typename _CharTy>
+inline const _CharTy* find_nesting_char(const _CharTy* first, const _CharTy* last, std::false_type)
+{
+    while (first != last && !is_nesting_char(*first))
+        ++first;
+    return first;
+}
+
+template <typename _CharTy>
+inline const _CharTy* find_nesting_char(const _CharTy* first, const _CharTy* last, std::true_type)
+{
+#if defined(__CONFIGOR_AVX2)
+    const __m256i quotes32         = _mm256_set1_epi8('"');
+    const __m256i slashes32        = _mm256_set1_epi8('/');
+    const __m256i open_brackets32  = _mm256_set1_epi8('[');
+    const __m256i close_brackets32 = _mm256_set1_epi8(']');
+    const __m256i open_braces32    = _mm256_set1_epi8('{');
+    const __m256i close_braces32   = _mm256_set1_epi8('}');
+    while (last - first >= 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const __m256i found = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quotes32), _mm256_cmpeq_epi8(chunk, slashes32)),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, open_brackets32), _mm256_cmpeq_epi8(chunk, close_brackets32)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, open_braces32), _mm256_cmpeq_epi8(chunk, close_braces32))));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 32;
+    }
+#endif
+#if defined(__CONFIGOR_SSE2) || defined(__CONFIGOR_AVX2)
+    const __m128i quotes         = _mm_set1_epi8('"');
+    const __m128i slashes        = _mm_set1_epi8('/');
+    const __m128i open_brackets  = _mm_set1_epi8('[');
+    const __m128i close_brackets = _mm_set1_epi8(']');
+    const __m128i open_braces    = _mm_set1_epi8('{');
+    const __m128i close_braces   = _mm_set1_epi8('}');
+    while (last - first >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i found = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, slashes)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, open_brackets), _mm_cmpeq_epi8(chunk, close_brackets)),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, open_braces), _mm_cmpeq_epi8(chunk, close_braces))));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask);
+        first += 16;
+    }
+#endif
+    return find_nesting_char(first, last, std::false_type{});
+}
+
+template <typename _CharTy>
+inline const _CharTy* find_nesting_char(const _CharTy* first, const _CharTy* last)
+{
+    return find_nesting_char(first, last, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// read_eight_digits
+// reads the ascii digits in [first, first + 8) at once with SWAR
+// returns false if any of them is not a digit
+//
+
+template <typename _CharTy>
+inline bool read_eight_digits(const _CharTy*, uint32_t&, std::false_type)
+{
+    return false;
+}
+
+template <typename _CharTy>
+inline bool read_eight_digits(const _CharTy* first, uint32_t& value, std::true_type)
+{
+#if defined(__CONFIGOR_LITTLE_ENDIAN)
+    uint64_t chunk = 0;
+    std::memcpy(&chunk, first, sizeof(chunk));
+
+    // every high nibble is 3, and adding 6 to the low nibble does not carry
+    const uint64_t high_nibbles = 0xF0F0F0F0F0F0F0F0;
+    if (((chunk & high_nibbles) | (((chunk + 0x0606060606060606) & high_nibbles) >> 4)) != 0x3333333333333333)
+        return false;
+
+    // combine adjacent digits, then pairs, then quads
+    chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+    chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+    value = static_cast<uint32_t>(((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+    return true;
+#else
+    (void)first;
+    (void)value;
+    return false;
+#endif
+}
+
+template <typename _CharTy>
+inline bool read_eight_digits(const _CharTy* first, uint32_t& value)
+{
+    return read_eight_digits(first, value, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+//
+// classify_block
+// sets a bit for every character of [block, block + 64) in the class it belongs to
+//
+
+struct block_masks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t structural;  // [ ] { } , :
+    uint64_t slash;
+};
+
+template <typename _CharTy>
+inline void classify_block(const _CharTy* block, block_masks& masks, std::false_type)
+{
+    masks = block_masks{ 0, 0, 0, 0, 0 };
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        const uint64_t bit = uint64_t(1) << i;
+        switch (block[i])
+        {
+        case '\"':
+            masks.quote |= bit;
+            break;
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            masks.whitespace |= bit;
+            break;
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case ',':
+        case ':':
+            masks.structural |= bit;
+            break;
+        case '/':
+            masks.slash |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+template <typename _CharTy>
+inline void classify_block(const _CharTy* block, block_masks& masks, std::true_type)
+{
+#if defined(__CONFIGOR_AVX2)
+    const __m256i quotes      = _mm256_set1_epi8('\"');
+    const __m256i backslashes = _mm256_set1_epi8('\\');
+    const __m256i slashes     = _mm256_set1_epi8('/');
+    const __m256i spaces      = _mm256_set1_epi8(' ');
+    const __m256i tabs        = _mm256_set1_epi8('\t');
+    const __m256i lfs         = _mm256_set1_epi8('\n');
+    const __m256i crs         = _mm256_set1_epi8('\r');
+    const __m256i commas      = _mm256_set1_epi8(',');
+    const __m256i colons      = _mm256_set1_epi8(':');
+    // '[' and ']' only differ from '{' and '}' in bit 0x20
+    const __m256i lowercase = _mm256_set1_epi8(0x20);
+    const __m256i brackets  = _mm256_set1_epi8('{');
+    const __m256i braces    = _mm256_set1_epi8('}');
+
+    masks = block_masks{ 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 2; ++i)
+    {
+        const __m256i chunk  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+        const __m256i folded = _mm256_or_si256(chunk, lowercase);
+        const __m256i ws =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, spaces), _mm256_cmpeq_epi8(chunk, tabs)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lfs), _mm256_cmpeq_epi8(chunk, crs)));
+        const __m256i st =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, brackets), _mm256_cmpeq_epi8(folded, braces)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, commas), _mm256_cmpeq_epi8(chunk, colons)));
+
+        const int shift = i * 32;
+        masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quotes)))) << shift;
+        masks.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslashes)))) << shift;
+        masks.slash |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, slashes)))) << shift;
+        masks.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(ws))) << shift;
+        masks.structural |= uint64_t(uint32_t(_mm256_movemask_epi8(st))) << shift;
+    }
+#elif defined(__CONFIGOR_SSE2)
+    const __m128i quotes      = _mm_set1_epi8('\"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i slashes     = _mm_set1_epi8('/');
+    const __m128i spaces      = _mm_set1_epi8(' ');
+    const __m128i tabs        = _mm_set1_epi8('\t');
+    const __m128i lfs         = _mm_set1_epi8('\n');
+    const __m128i crs         = _mm_set1_epi8('\r');
+    const __m128i commas      = _mm_set1_epi8(',');
+    const __m128i colons      = _mm_set1_epi8(':');
+    const __m128i lowercase   = _mm_set1_epi8(0x20);
+    const __m128i brackets    = _mm_set1_epi8('{');
+    const __m128i braces      = _mm_set1_epi8('}');
+
+    masks = block_masks{ 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i chunk  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        const __m128i folded = _mm_or_si128(chunk, lowercase);
+        const __m128i ws     = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, tabs)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, lfs), _mm_cmpeq_epi8(chunk, crs)));
+        const __m128i st = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, brackets), _mm_cmpeq_epi8(folded, braces)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, commas), _mm_cmpeq_epi8(chunk, colons)));
+
+        const int shift = i * 16;
+        masks.quote |= uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quotes)) & 0xFFFF) << shift;
+        masks.backslash |= uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslashes)) & 0xFFFF) << shift;
+        masks.slash |= uint64_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, slashes)) & 0xFFFF) << shift;
+        masks.whitespace |= uint64_t(_mm_movemask_epi8(ws) & 0xFFFF) << shift;
+        masks.structural |= uint64_t(_mm_movemask_epi8(st) & 0xFFFF) << shift;
+    }
+#else
+    classify_block(block, masks, std::false_type{});
+#endif
+}
+
+template <typename _CharTy>
+inline void classify_block(const _CharTy* block, block_masks& masks)
+{
+    classify_block(block, masks, std::integral_constant<bool, sizeof(_CharTy) == 1>{});
+}
+
+}  // namespace simd
+
+}  // namespace detail
+
+}  // namespace configor
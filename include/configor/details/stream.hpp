@@ -207,14 +207,14 @@ namespace detail
 // ostreambuf
 //
 
-template <typename _CharTy>
+template <typename _CharTy, typename _StringTy = std::basic_string<_CharTy>>
 class fast_string_ostreambuf : public std::basic_streambuf<_CharTy>
 {
 public:
     using char_type   = _CharTy;
     using traits_type = typename std::basic_streambuf<char_type>::traits_type;
     using int_type    = typename std::basic_streambuf<char_type>::int_type;
-    using string_type = std::basic_string<char_type>;
+    using string_type = _StringTy;
 
     explicit fast_string_ostreambuf(string_type& str)
         : str_(str)
@@ -333,6 +333,28 @@ private:
     const size_t     size_;
 };
 
+template <typename _CharTy>
+class fast_range_istreambuf : public std::basic_streambuf<_CharTy>
+{
+public:
+    using char_type   = _CharTy;
+    using traits_type = typename std::basic_streambuf<char_type>::traits_type;
+    using int_type    = typename std::basic_streambuf<char_type>::int_type;
+
+    fast_range_istreambuf() = default;
+
+    fast_range_istreambuf(const char_type* first, const char_type* last)
+    {
+        reset(first, last);
+    }
+
+    inline void reset(const char_type* first, const char_type* last)
+    {
+        // the get area is never written through
+        this->setg(const_cast<char_type*>(first), const_cast<char_type*>(first), const_cast<char_type*>(last));
+    }
+};
+
 template <typename _CharTy>
 class fast_cfile_istreambuf;
 
@@ -369,9 +391,15 @@ protected:
 
     virtual std::streamsize xsgetn(char_type* s, std::streamsize num) override
     {
-        if (std::fgets(s, static_cast<int>(num), file_) == nullptr)
-            return 0;
-        return num;
+        std::streamsize count = 0;
+        if (num > 0 && last_char_ != 0)
+        {
+            if (last_char_ == traits_type::eof())
+                return 0;
+            s[count++] = traits_type::to_char_type(last_char_);
+            last_char_ = 0;
+        }
+        return count + static_cast<std::streamsize>(std::fread(s + count, 1, static_cast<size_t>(num - count), file_));
     }
 
 private:
@@ -412,9 +440,15 @@ protected:
 
     virtual std::streamsize xsgetn(char_type* s, std::streamsize num) override
     {
-        if (std::fgetws(s, static_cast<int>(num), file_) == nullptr)
-            return 0;
-        return num;
+        std::streamsize count = 0;
+        for (; count < num; ++count)
+        {
+            const int_type c = uflow();
+            if (c == traits_type::eof())
+                break;
+            s[count] = traits_type::to_char_type(c);
+        }
+        return count;
     }
 
 private:
@@ -0,0 +1,162 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include <algorithm>  // std::min
+#include <cstddef>    // std::size_t
+#include <ostream>    // std::basic_ostream
+#include <string>     // std::char_traits, std::basic_string
+
+namespace configor
+{
+
+//
+// basic_string_view
+// a non-owning reference to a range of characters
+//
+
+template <typename _CharTy, typename _TraitsTy = std::char_traits<_CharTy>>
+class basic_string_view
+{
+public:
+    using char_type      = _CharTy;
+    using traits_type    = _TraitsTy;
+    using size_type      = std::size_t;
+    using const_iterator = const char_type*;
+
+    basic_string_view()
+        : data_(nullptr)
+        , size_(0)
+    {
+    }
+
+    basic_string_view(const char_type* data, size_type size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    basic_string_view(const char_type* str)
+        : data_(str)
+        , size_(traits_type::length(str))
+    {
+    }
+
+    template <typename _AllocTy>
+    basic_string_view(const std::basic_string<char_type, traits_type, _AllocTy>& str)
+        : data_(str.data())
+        , size_(str.size())
+    {
+    }
+
+    inline const char_type* data() const
+    {
+        return data_;
+    }
+
+    inline size_type size() const
+    {
+        return size_;
+    }
+
+    inline size_type length() const
+    {
+        return size_;
+    }
+
+    inline bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    inline const_iterator begin() const
+    {
+        return data_;
+    }
+
+    inline const_iterator end() const
+    {
+        return data_ + size_;
+    }
+
+    inline const char_type& operator[](size_type index) const
+    {
+        return data_[index];
+    }
+
+    int compare(const basic_string_view& other) const
+    {
+        const int result = traits_type::compare(data_, other.data_, (std::min)(size_, other.size_));
+        if (result != 0)
+            return result;
+        return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+    }
+
+    template <typename _AllocTy>
+    explicit operator std::basic_string<char_type, traits_type, _AllocTy>() const
+    {
+        return std::basic_string<char_type, traits_type, _AllocTy>(data_, size_);
+    }
+
+    friend inline bool operator==(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return lhs.size_ == rhs.size_ && lhs.compare(rhs) == 0;
+    }
+
+    friend inline bool operator!=(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend inline bool operator<(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    friend inline bool operator<=(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    friend inline bool operator>(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    friend inline bool operator>=(const basic_string_view& lhs, const basic_string_view& rhs)
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    friend inline std::basic_ostream<char_type, traits_type>& operator<<(std::basic_ostream<char_type, traits_type>& os,
+                                                                         const basic_string_view&                    sv)
+    {
+        return os.write(sv.data_, static_cast<std::streamsize>(sv.size_));
+    }
+
+private:
+    const char_type* data_;
+    size_type        size_;
+};
+
+using string_view  = basic_string_view<char>;
+using wstring_view = basic_string_view<wchar_t>;
+
+}  // namespace configor
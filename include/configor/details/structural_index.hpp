@@ -0,0 +1,201 @@
+// Copyright (c) 2018-2020 configor - Nomango
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+#include "simd.hpp"
+
+#include <algorithm>  // std::fill, std::copy
+#include <cstddef>    // std::size_t
+#include <cstdint>    // uint32_t, uint64_t
+#include <limits>     // std::numeric_limits
+#include <vector>     // std::vector
+
+namespace configor
+{
+
+namespace detail
+{
+
+//
+// structural_index
+// the positions where tokens begin in a json text: brackets, separators, opening quotes and the first
+// character of every number or literal, found 64 characters at a time with bit masks
+//
+
+template <typename _CharTy>
+class structural_index
+{
+public:
+    using char_type = _CharTy;
+    using size_type = std::size_t;
+
+    structural_index()
+        : first_(nullptr)
+        , last_(nullptr)
+        , valid_(false)
+        , positions_()
+    {
+    }
+
+    structural_index(const char_type* first, const char_type* last)
+        : structural_index()
+    {
+        build(first, last);
+    }
+
+    void build(const char_type* first, const char_type* last)
+    {
+        first_ = first;
+        last_  = last;
+        valid_ = false;
+        positions_.clear();
+
+        const auto length = static_cast<std::size_t>(last - first);
+        if (length > (std::numeric_limits<uint32_t>::max)())
+            return;
+        positions_.reserve(length / 8);
+
+        uint64_t prev_in_string = 0;
+        uint64_t prev_escaped   = 0;
+        uint64_t prev_scalar    = 0;
+        uint64_t slashes        = 0;
+        for (std::size_t offset = 0; offset < length; offset += 64)
+        {
+            simd::block_masks masks;
+            if (length - offset >= 64)
+            {
+                simd::classify_block(first + offset, masks);
+            }
+            else
+            {
+                // pad the last block with whitespace
+                char_type block[64];
+                std::fill(std::copy(first + offset, last, block), block + 64, char_type(' '));
+                simd::classify_block(block, masks);
+            }
+
+            // characters following an unescaped backslash
+            uint64_t escaped   = prev_escaped;
+            uint64_t backslash = masks.backslash & ~escaped;
+            prev_escaped       = 0;
+            while (backslash != 0)
+            {
+                const uint64_t bit = backslash & (~backslash + 1);
+                if (bit == (uint64_t(1) << 63))
+                    prev_escaped = 1;
+                escaped |= bit << 1;
+                backslash &= ~(bit | (bit << 1));
+            }
+
+            // the bits from an opening quote up to the closing quote
+            const uint64_t quotes    = masks.quote & ~escaped;
+            const uint64_t in_string = prefix_xor(quotes) ^ prev_in_string;
+            prev_in_string           = (in_string >> 63) ? ~uint64_t(0) : 0;
+
+            const uint64_t scalar = ~(masks.whitespace | masks.structural | masks.quote | in_string);
+            const uint64_t starts = scalar & ~((scalar << 1) | prev_scalar);
+            prev_scalar           = scalar >> 63;
+            slashes |= masks.slash & ~in_string;
+
+            uint64_t bits = (masks.structural & ~in_string) | (quotes & in_string) | starts;
+            while (bits != 0)
+            {
+                positions_.push_back(static_cast<uint32_t>(offset + simd::count_trailing_zeros(bits)));
+                bits &= bits - 1;
+            }
+        }
+
+        // comments and unterminated strings are left to the parser
+        valid_ = (prev_in_string == 0 && slashes == 0);
+    }
+
+    // false if the input has comments or an unterminated string
+    inline bool valid() const
+    {
+        return valid_;
+    }
+
+    inline const char_type* begin_of_input() const
+    {
+        return first_;
+    }
+
+    inline const char_type* end_of_input() const
+    {
+        return last_;
+    }
+
+    // the count of tokens
+    inline size_type size() const
+    {
+        return positions_.size();
+    }
+
+    inline const char_type* operator[](size_type i) const
+    {
+        return first_ + positions_[i];
+    }
+
+    // the token closing the array or object opened by token i, or size() if it is not closed
+    size_type find_close(size_type i) const
+    {
+        size_type depth = 0;
+        for (; i < positions_.size(); ++i)
+        {
+            switch (first_[positions_[i]])
+            {
+            case '[':
+            case '{':
+                ++depth;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0)
+                    return i;
+                break;
+            default:
+                break;
+            }
+        }
+        return positions_.size();
+    }
+
+private:
+    static inline uint64_t prefix_xor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+private:
+    const char_type*      first_;
+    const char_type*      last_;
+    bool                  valid_;
+    std::vector<uint32_t> positions_;
+};
+
+}  // namespace detail
+
+}  // namespace configor
@@ -20,6 +20,7 @@
 
 #pragma once
 #include "iterator.hpp"
+#include "string_view.hpp"
 
 #include <algorithm>    // std::for_each, std::all_of
 #include <cmath>        // std::fabs
@@ -676,6 +677,19 @@ public:
         return get<_Ty>();
     }
 
+public:
+    // get_string_view
+
+    basic_string_view<char_type> get_string_view() const
+    {
+        if (!is_string())
+        {
+            throw configor_type_error(std::string("incompatible type for get_string_view, actual type is ")
+                                      + to_string(type()));
+        }
+        return basic_string_view<char_type>(data().string->data(), data().string->size());
+    }
+
 public:
     // swap function
     inline void swap(basic_value& rhs)
@@ -1035,6 +1049,37 @@ public:
     }
 
     static void destroy(value_type& v)
+    {
+        // only arrays and objects can nest, so other values skip the depth counter
+        if (!is_container(v))
+        {
+            destroy_data(v);
+            return;
+        }
+
+        // the nesting below this depth is destroyed with a stack on the heap instead of recursion,
+        // so destroying a deeply nested value does not consume the call stack
+        static thread_local std::size_t depth = 0;
+        if (depth >= max_recursive_depth && has_nested_containers(v))
+        {
+            typename value_type::array_type stack;
+            move_nested_containers(v, stack);
+            while (!stack.empty())
+            {
+                // current has no nested arrays or objects left when it is destroyed
+                value_type current{ std::move(stack.back()) };
+                stack.pop_back();
+                move_nested_containers(current, stack);
+            }
+        }
+
+        ++depth;
+        destroy_data(v);
+        --depth;
+    }
+
+private:
+    static void destroy_data(value_type& v)
     {
         switch (v.type())
         {
@@ -1052,7 +1097,60 @@ public:
         }
     }
 
-private:
+    static inline bool is_container(const value_type& v)
+    {
+        return v.type() == value_constant::object || v.type() == value_constant::array;
+    }
+
+    static const std::size_t max_recursive_depth = 256;
+
+    static bool has_nested_containers(const value_type& v)
+    {
+        switch (v.type())
+        {
+        case value_constant::object:
+            for (const auto& pair : *v.data().object)
+            {
+                if (is_container(pair.second))
+                    return true;
+            }
+            break;
+        case value_constant::array:
+            for (const auto& element : *v.data().vector)
+            {
+                if (is_container(element))
+                    return true;
+            }
+            break;
+        default:
+            break;
+        }
+        return false;
+    }
+
+    static void move_nested_containers(value_type& v, typename value_type::array_type& stack)
+    {
+        switch (v.type())
+        {
+        case value_constant::object:
+            for (auto& pair : *v.data().object)
+            {
+                if (is_container(pair.second))
+                    stack.push_back(std::move(pair.second));
+            }
+            break;
+        case value_constant::array:
+            for (auto& element : *v.data().vector)
+            {
+                if (is_container(element))
+                    stack.push_back(std::move(element));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
     template <typename... _Args>
     static inline void construct(type_constant<value_constant::object>, value_type& v, _Args&&... args)
     {
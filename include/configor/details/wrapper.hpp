@@ -19,9 +19,13 @@
 // THE SOFTWARE.
 
 #pragma once
+#include "conversion.hpp"
 #include "parser.hpp"
 #include "serializer.hpp"
 
+#include <type_traits>  // std::integral_constant, std::is_default_constructible
+#include <utility>      // std::move
+
 namespace configor
 {
 
@@ -46,12 +50,25 @@ public:
         typename std::basic_ostream<_TargetCharTy, _Traits>::sentry s(out);
         if (s)
         {
-            config_type::dump(out, static_cast<value_type>(wrapper.v_));
+            write(out, wrapper.v_, has_field_table<value_type, _Ty>{});
         }
         return out;
     }
 
 private:
+    // types bound by CONFIGOR_BIND are dumped straight from their fields
+    template <typename _TargetCharTy>
+    static void write(std::basic_ostream<_TargetCharTy>& out, const _Ty& v, std::true_type)
+    {
+        config_type::dump(out, v);
+    }
+
+    template <typename _TargetCharTy>
+    static void write(std::basic_ostream<_TargetCharTy>& out, const _Ty& v, std::false_type)
+    {
+        config_type::dump(out, static_cast<value_type>(v));
+    }
+
     const _Ty& v_;
 };
 
@@ -104,14 +121,34 @@ public:
         typename std::basic_istream<_SourceCharTy, _Traits>::sentry s(in);
         if (s)
         {
-            value_type c{};
-            config_type::parse(c, in);
-            const_cast<_Ty&>(wrapper.v_) = c.template get<_Ty>();
+            using direct = std::integral_constant<
+                bool, has_field_table<value_type, _Ty>::value && std::is_default_constructible<_Ty>::value
+                          && std::is_same<_SourceCharTy, typename value_type::char_type>::value
+                          && std::is_same<_Traits, std::char_traits<_SourceCharTy>>::value>;
+            read(in, const_cast<_Ty&>(wrapper.v_), direct{});
         }
         return in;
     }
 
 private:
+    // types bound by CONFIGOR_BIND are parsed straight into the fields of a new object,
+    // which replaces v only if parsing succeeds
+    template <typename _SourceCharTy>
+    static void read(std::basic_istream<_SourceCharTy>& in, _Ty& v, std::true_type)
+    {
+        _Ty value{};
+        config_type::parse_into(value, in);
+        v = std::move(value);
+    }
+
+    template <typename _SourceCharTy, typename _Traits>
+    static void read(std::basic_istream<_SourceCharTy, _Traits>& in, _Ty& v, std::false_type)
+    {
+        value_type c{};
+        config_type::parse(c, in);
+        v = c.template get<_Ty>();
+    }
+
     _Ty& v_;
 };
 
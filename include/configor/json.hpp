@@ -20,21 +20,59 @@
 
 #pragma once
 #include "configor.hpp"
+#include "details/ndjson.hpp"
+#include "details/structural_index.hpp"
 
 #include <algorithm>  // std::for_each
+#include <cstdint>    // std::uint64_t
 #include <iomanip>    // std::setprecision
 #include <ios>        // std::noskipws, std::noshowbase, std::right
+#include <limits>     // std::numeric_limits
+#include <map>        // std::map
+#include <memory>     // std::unique_ptr, std::shared_ptr, std::addressof
+#include <set>        // std::set
+#include <stdexcept>  // std::out_of_range
+#include <string>     // std::basic_string, std::char_traits
+#include <vector>     // std::vector
 
 namespace configor
 {
 
 namespace detail
 {
-template <typename _ValTy, typename _SourceCharTy>
+struct json_parser_traits;
+
+struct json_serializer_traits;
+
+template <typename _ValTy, typename _SourceCharTy, typename _TraitsTy = json_parser_traits>
 class json_parser;
 
-template <typename _ValTy, typename _TargetCharTy>
+template <typename _ValTy, typename _TargetCharTy, typename _TraitsTy = json_serializer_traits>
 class json_serializer;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_reader;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_push_parser;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding,
+          typename _OptionsTy = option_list<>>
+class json_lazy_value;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_selector;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_field_reader;
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_parser_context;
+
+template <typename _ValTy, typename _TargetCharTy, template <class> class _DefaultEncoding>
+class json_writer_context;
+
+struct json_opts;
 }  // namespace detail
 
 template <typename _Args, template <typename> class _DefaultEncoding = encoding::auto_utf>
@@ -53,11 +91,155 @@ public:
 
     using parser = typename detail::parsable<_Args, detail::json_parser,
                                              _DefaultEncoding>::template parser_type<typename value::char_type>;
+
+    using sax_handler = basic_sax_handler<value>;
+
+    using string_view = basic_string_view<typename value::char_type>;
+
+    using reader = detail::json_reader<value, typename value::char_type, _DefaultEncoding>;
+
+    using structural_index = detail::structural_index<typename value::char_type>;
+
+    using push_parser = detail::json_push_parser<value, typename value::char_type, _DefaultEncoding>;
+
+    using ndjson = detail::ndjson<basic_json>;
+
+    using lazy_value = detail::json_lazy_value<value, typename value::char_type, _DefaultEncoding>;
+
+    // the buffer must outlive the returned value and the values found in it
+    // the options are kept to parse the values requested by materialize() and get()
+    static lazy_value lazy_parse(const typename value::char_type* buffer, std::size_t size,
+                                 std::initializer_list<typename lazy_value::option> options = {})
+    {
+        return lazy_value(buffer, buffer + size, options);
+    }
+
+    static lazy_value lazy_parse(const typename value::char_type*                str,
+                                 std::initializer_list<typename lazy_value::option> options = {})
+    {
+        return lazy_parse(str, std::char_traits<typename value::char_type>::length(str), options);
+    }
+
+    static lazy_value lazy_parse(const typename value::string_type&              str,
+                                 std::initializer_list<typename lazy_value::option> options = {})
+    {
+        return lazy_parse(str.data(), str.size(), options);
+    }
+
+    // the result would refer to a destroyed string
+    static lazy_value lazy_parse(typename value::string_type&&                    str,
+                                 std::initializer_list<typename lazy_value::option> options = {}) = delete;
+
+    // the lazy value with the traits of options given as types
+    // e.g. json::lazy_parse<json::opts::no_comments>(str)
+    template <typename... _Opts>
+    using policy_lazy_value =
+        detail::json_lazy_value<value, typename value::char_type, _DefaultEncoding, detail::option_list<_Opts...>>;
+
+    template <typename _Opt, typename... _Opts>
+    static typename std::enable_if<detail::is_option<_Opt>::value, policy_lazy_value<_Opt, _Opts...>>::type
+    lazy_parse(const typename value::char_type* buffer, std::size_t size,
+               std::initializer_list<typename policy_lazy_value<_Opt, _Opts...>::option> options = {})
+    {
+        return policy_lazy_value<_Opt, _Opts...>(buffer, buffer + size, options);
+    }
+
+    template <typename _Opt, typename... _Opts>
+    static typename std::enable_if<detail::is_option<_Opt>::value, policy_lazy_value<_Opt, _Opts...>>::type
+    lazy_parse(const typename value::char_type*                                         str,
+               std::initializer_list<typename policy_lazy_value<_Opt, _Opts...>::option> options = {})
+    {
+        return lazy_parse<_Opt, _Opts...>(str, std::char_traits<typename value::char_type>::length(str), options);
+    }
+
+    template <typename _Opt, typename... _Opts>
+    static typename std::enable_if<detail::is_option<_Opt>::value, policy_lazy_value<_Opt, _Opts...>>::type
+    lazy_parse(const typename value::string_type&                                       str,
+               std::initializer_list<typename policy_lazy_value<_Opt, _Opts...>::option> options = {})
+    {
+        return lazy_parse<_Opt, _Opts...>(str.data(), str.size(), options);
+    }
+
+    template <typename _Opt, typename... _Opts>
+    static typename std::enable_if<detail::is_option<_Opt>::value, policy_lazy_value<_Opt, _Opts...>>::type
+    lazy_parse(typename value::string_type&&                                            str,
+               std::initializer_list<typename policy_lazy_value<_Opt, _Opts...>::option> options = {}) = delete;
+
+    // reusable parser and serializer for many small documents, e.g. one per thread
+    using parser_context = detail::json_parser_context<value, typename value::char_type, _DefaultEncoding>;
+
+    using writer_context = detail::json_writer_context<value, typename value::char_type, _DefaultEncoding>;
+
+    // options given as types, e.g. json::parse<json::opts::max_depth<64>, json::opts::utf8>(str)
+    using opts = detail::json_opts;
+
+    using selector = detail::json_selector<value, typename value::char_type, _DefaultEncoding>;
+
+    // parses only the values at the json pointers and their ancestors, anything else is skipped without validation
+    static value parse_select(const typename value::char_type* buffer, std::size_t size,
+                              const std::vector<typename value::string_type>& pointers,
+                              std::initializer_list<typename reader::option> options = {})
+    {
+        reader r(buffer, size, options);
+        return selector(pointers).select(r);
+    }
+
+    static value parse_select(const typename value::char_type* str,
+                              const std::vector<typename value::string_type>& pointers,
+                              std::initializer_list<typename reader::option> options = {})
+    {
+        return parse_select(str, std::char_traits<typename value::char_type>::length(str), pointers, options);
+    }
+
+    static value parse_select(const typename value::string_type& str,
+                              const std::vector<typename value::string_type>& pointers,
+                              std::initializer_list<typename reader::option> options = {})
+    {
+        return parse_select(str.data(), str.size(), pointers, options);
+    }
+
+    using field_reader = detail::json_field_reader<value, typename value::char_type, _DefaultEncoding>;
+
+    // parses straight into a type bound by CONFIGOR_BIND, unknown keys are skipped
+    // the result and the errors are the same as parse().get<_Ty>(), but the object is partially read after an error
+    template <typename _Ty, typename = typename std::enable_if<detail::has_field_table<value, _Ty>::value>::type>
+    static void parse_into(_Ty& v, const typename value::char_type* buffer, std::size_t size,
+                           std::initializer_list<typename reader::option> options = {})
+    {
+        reader r(buffer, size, options);
+        field_reader::read_document(r, v);
+    }
+
+    template <typename _Ty, typename = typename std::enable_if<detail::has_field_table<value, _Ty>::value>::type>
+    static void parse_into(_Ty& v, const typename value::char_type* str,
+                           std::initializer_list<typename reader::option> options = {})
+    {
+        parse_into(v, str, std::char_traits<typename value::char_type>::length(str), options);
+    }
+
+    template <typename _Ty, typename = typename std::enable_if<detail::has_field_table<value, _Ty>::value>::type>
+    static void parse_into(_Ty& v, const typename value::string_type& str,
+                           std::initializer_list<typename reader::option> options = {})
+    {
+        parse_into(v, str.data(), str.size(), options);
+    }
+
+    template <typename _Ty, typename = typename std::enable_if<detail::has_field_table<value, _Ty>::value>::type>
+    static void parse_into(_Ty& v, std::basic_istream<typename value::char_type>& is,
+                           std::initializer_list<typename reader::option> options = {})
+    {
+        reader r(is, options);
+        field_reader::read_document(r, v);
+    }
 };
 
 using json  = basic_json<value_tplargs>;
 using wjson = basic_json<wvalue_tplargs>;
 
+using insitu_json = basic_json<insitu_value_tplargs>;
+
+using interned_json = basic_json<interned_value_tplargs>;
+
 // type traits
 
 template <typename _Ty>
@@ -82,7 +264,7 @@ struct json_hex
     friend inline std::basic_ostream<_CharTy>& operator<<(std::basic_ostream<_CharTy>& os, const json_hex& i)
     {
         os << std::setfill(_CharTy('0')) << std::hex << std::uppercase;
-        os << '\\' << 'u' << std::setw(sizeof(i.i)) << i.i;
+        os << '\\' << 'u' << std::setw(4) << i.i;
         os << std::dec << std::nouppercase;
         return os;
     }
@@ -99,17 +281,248 @@ inline json_hex<_IntTy> make_json_hex(const _IntTy i)
 
 }  // namespace
 
+//
+// json_parser_traits
+// json_serializer_traits
+// settings fixed at compile time, the code for the other cases is left out of the parser and serializer
+// an encoding given as a type is called directly, if void the encoding set at runtime is called through a pointer
+//
+
+struct json_parser_traits
+{
+    // comments are skipped like whitespace, otherwise they fail to parse
+    static constexpr bool comments = true;
+
+    template <typename _CharTy>
+    using source_encoding = void;
+
+    template <typename _CharTy>
+    using target_encoding = void;
+};
+
+struct json_serializer_traits
+{
+    // the output is indented if an indent is set, otherwise it is always compact
+    static constexpr bool pretty = true;
+
+    template <typename _CharTy>
+    using source_encoding = void;
+
+    template <typename _CharTy>
+    using target_encoding = void;
+};
+
+//
+// json_opts
+// parser and serializer options given as types, an option changes the traits of the parser or serializer
+// and sets the other settings once it is constructed
+// like the serializer options, the output of dump is indented by the width and fill of the stream unless indent is given
+//
+
+struct json_opts
+{
+    struct option : option_tag
+    {
+        template <typename _TraitsTy>
+        using parser_traits = _TraitsTy;
+
+        template <typename _TraitsTy>
+        using serializer_traits = _TraitsTy;
+
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy&)
+        {
+        }
+
+        template <typename _SerializerTy>
+        static void apply_serializer(_SerializerTy&)
+        {
+        }
+    };
+
+    // parser options
+
+    template <std::size_t _MaxDepth>
+    struct max_depth : option
+    {
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy& p)
+        {
+            p.set_max_depth(_MaxDepth);
+        }
+    };
+
+    template <bool _Enabled>
+    struct integer_promotion : option
+    {
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy& p)
+        {
+            p.set_integer_promotion(_Enabled);
+        }
+    };
+
+    struct insitu_strings : option
+    {
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy& p)
+        {
+            p.set_insitu_strings(true);
+        }
+    };
+
+    struct structural_index : option
+    {
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy& p)
+        {
+            p.set_structural_index(nullptr);
+        }
+    };
+
+    struct key_interning : option
+    {
+        template <typename _ParserTy>
+        static void apply_parser(_ParserTy& p)
+        {
+            p.set_intern_table(nullptr);
+        }
+    };
+
+    struct no_comments : option
+    {
+        template <typename _TraitsTy>
+        struct parser_traits : _TraitsTy
+        {
+            static constexpr bool comments = false;
+        };
+    };
+
+    // serializer options
+
+    template <uint8_t _IndentStep, int _IndentChar = ' '>
+    struct indent : option
+    {
+        template <typename _TraitsTy>
+        struct serializer_traits : _TraitsTy
+        {
+            static constexpr bool pretty = (_IndentStep > 0);
+        };
+
+        template <typename _SerializerTy>
+        static void apply_serializer(_SerializerTy& s)
+        {
+            s.set_indent(_IndentStep, static_cast<typename _SerializerTy::target_char_type>(_IndentChar));
+        }
+    };
+
+    struct unicode_escaping : option
+    {
+        template <typename _SerializerTy>
+        static void apply_serializer(_SerializerTy& s)
+        {
+            s.set_unicode_escaping(true);
+        }
+    };
+
+    template <int _Precision>
+    struct precision : option
+    {
+        template <typename _SerializerTy>
+        static void apply_serializer(_SerializerTy& s)
+        {
+            s.set_precision(_Precision);
+        }
+    };
+
+    template <bool _Enabled>
+    struct shortest_float : option
+    {
+        template <typename _SerializerTy>
+        static void apply_serializer(_SerializerTy& s)
+        {
+            s.set_shortest_float(_Enabled);
+        }
+    };
+
+    // encodings apply to both
+
+    template <template <class> class _Encoding>
+    struct encoding : option
+    {
+        template <typename _TraitsTy>
+        struct traits : _TraitsTy
+        {
+            template <typename _CharTy>
+            using source_encoding = _Encoding<_CharTy>;
+
+            template <typename _CharTy>
+            using target_encoding = _Encoding<_CharTy>;
+        };
+
+        template <typename _TraitsTy>
+        using parser_traits = traits<_TraitsTy>;
+
+        template <typename _TraitsTy>
+        using serializer_traits = traits<_TraitsTy>;
+    };
+
+    template <template <class> class _Encoding>
+    struct source_encoding : option
+    {
+        template <typename _TraitsTy>
+        struct traits : _TraitsTy
+        {
+            template <typename _CharTy>
+            using source_encoding = _Encoding<_CharTy>;
+        };
+
+        template <typename _TraitsTy>
+        using parser_traits = traits<_TraitsTy>;
+
+        template <typename _TraitsTy>
+        using serializer_traits = traits<_TraitsTy>;
+    };
+
+    template <template <class> class _Encoding>
+    struct target_encoding : option
+    {
+        template <typename _TraitsTy>
+        struct traits : _TraitsTy
+        {
+            template <typename _CharTy>
+            using target_encoding = _Encoding<_CharTy>;
+        };
+
+        template <typename _TraitsTy>
+        using parser_traits = traits<_TraitsTy>;
+
+        template <typename _TraitsTy>
+        using serializer_traits = traits<_TraitsTy>;
+    };
+
+    using utf8  = encoding<::configor::encoding::utf8>;
+    using utf16 = encoding<::configor::encoding::utf16>;
+    using utf32 = encoding<::configor::encoding::utf32>;
+};
+
 //
 // json_parser
 //
 
-template <typename _ValTy, typename _SourceCharTy>
-class json_parser : public basic_parser<_ValTy, _SourceCharTy>
+template <typename _ValTy, typename _SourceCharTy, typename _TraitsTy>
+class json_parser : public basic_parser<_ValTy, _SourceCharTy, json_parser<_ValTy, _SourceCharTy, _TraitsTy>>
 {
 public:
     using value_type       = _ValTy;
     using source_char_type = _SourceCharTy;
     using target_char_type = typename value_type::char_type;
+    using traits_type      = _TraitsTy;
+
+    // the parser with the traits changed by options given as types
+    template <typename _OptionsTy>
+    using rebind_options =
+        json_parser<value_type, source_char_type, typename _OptionsTy::template parser_traits<traits_type>>;
 
     using option = std::function<void(json_parser&)>;
 
@@ -118,6 +531,54 @@ public:
         return [=](json_parser& p) { p.set_error_handler(eh); };
     }
 
+    // arrays and objects nested deeper than max_depth fail to parse
+    static option with_max_depth(std::size_t max_depth)
+    {
+        return [=](json_parser& p) { p.set_max_depth(max_depth); };
+    }
+
+    // integers which overflow integer_type are parsed as float_type
+    // or fail if disabled
+    static option with_integer_promotion(bool enabled)
+    {
+        return [=](json_parser& p) { p.set_integer_promotion(enabled); };
+    }
+
+    // strings without escapes refer to the parsed buffer instead of being copied
+    // only applies to contiguous input and string types with assign_view(), such as basic_insitu_string,
+    // the buffer must outlive the parsed values
+    static option with_insitu_strings(bool enabled)
+    {
+        return [=](json_parser& p) { p.set_insitu_strings(enabled); };
+    }
+
+    // the parser jumps over whitespace and skipped values with a structural index of the whole input
+    // strings and numbers are still scanned character by character
+    // only applies to contiguous input without comments
+    static option with_structural_index()
+    {
+        return [=](json_parser& p) { p.set_structural_index(nullptr); };
+    }
+
+    // the index must be built over the same buffer and outlive the parser
+    static option with_structural_index(const structural_index<source_char_type>& index)
+    {
+        return [&](json_parser& p) { p.set_structural_index(&index); };
+    }
+
+    // object keys share the characters interned by a table for the whole parse
+    // only applies to string types with assign_shared(), such as basic_interned_string
+    static option with_key_interning()
+    {
+        return [=](json_parser& p) { p.set_intern_table(nullptr); };
+    }
+
+    // the table may be reused by many parsers, but not at the same time
+    static option with_key_interning(basic_intern_table<target_char_type>& table)
+    {
+        return [&](json_parser& p) { p.set_intern_table(&table); };
+    }
+
     template <template <class> class _Encoding>
     static option with_encoding()
     {
@@ -141,11 +602,42 @@ public:
     }
 
     explicit json_parser(std::basic_istream<source_char_type>& is)
-        : basic_parser<value_type, source_char_type>(is)
+        : basic_parser<value_type, source_char_type, json_parser>(is)
+        , is_negative_(false)
+        , integer_promotion_(true)
+        , insitu_strings_(false)
+        , index_(nullptr)
+        , index_pos_(0)
+        , owned_index_()
+        , owns_index_(false)
+        , eof_(false)
+        , current_(0)
+        , number_integer_(0)
+        , number_float_(0)
+        , significand_(0)
+        , exponent_(0)
+        , digits_(0)
+        , extra_digits_()
+    {
+    }
+
+    json_parser(const source_char_type* first, const source_char_type* last)
+        : basic_parser<value_type, source_char_type, json_parser>(first, last)
         , is_negative_(false)
+        , integer_promotion_(true)
+        , insitu_strings_(false)
+        , index_(nullptr)
+        , index_pos_(0)
+        , owned_index_()
+        , owns_index_(false)
+        , eof_(false)
         , current_(0)
         , number_integer_(0)
         , number_float_(0)
+        , significand_(0)
+        , exponent_(0)
+        , digits_(0)
+        , extra_digits_()
     {
     }
 
@@ -154,66 +646,204 @@ public:
         std::for_each(options.begin(), options.end(), [&](const option& option) { option(*this); });
     }
 
-    virtual void parse(value_type& c) override
+    inline void set_integer_promotion(bool enabled)
+    {
+        integer_promotion_ = enabled;
+    }
+
+    inline void set_insitu_strings(bool enabled)
+    {
+        insitu_strings_ = enabled;
+    }
+
+    // an encoding of the traits is kept
+    template <template <class> class _Encoding>
+    inline void set_source_encoding()
+    {
+        basic_parser<value_type, source_char_type, json_parser>::template set_source_encoding<
+            traits_encoding<_Encoding>::template source>();
+    }
+
+    template <template <class> class _Encoding>
+    inline void set_target_encoding()
+    {
+        basic_parser<value_type, source_char_type, json_parser>::template set_target_encoding<
+            traits_encoding<_Encoding>::template target>();
+    }
+
+    // parses another buffer with the same settings
+    // an owned structural index is rebuilt, while an index given by the user only applies to its own buffer
+    void reset(const source_char_type* first, const source_char_type* last)
+    {
+        basic_parser<value_type, source_char_type, json_parser>::reset(first, last);
+
+        is_negative_    = false;
+        eof_            = false;
+        current_        = 0;
+        number_integer_ = 0;
+        number_float_   = 0;
+        significand_    = 0;
+        exponent_       = 0;
+        digits_         = 0;
+        extra_digits_.clear();
+
+        if (owns_index_)
+            set_structural_index(nullptr);
+        else if (index_)
+            set_structural_index(index_);
+    }
+
+    void parse(value_type& c)
     {
         // read first char
         read_next();
-        basic_parser<value_type, source_char_type>::parse(c);
+        basic_parser<value_type, source_char_type, json_parser>::parse(c);
     }
 
-    virtual void get_integer(typename value_type::integer_type& out) override
+    template <typename _HandlerTy>
+    bool sax_parse(_HandlerTy& handler)
     {
-        out = is_negative_ ? -number_integer_ : number_integer_;
+        // read first char
+        read_next();
+        return basic_parser<value_type, source_char_type, json_parser>::sax_parse(handler);
+    }
+
+    void get_integer(typename value_type::integer_type& out)
+    {
+        out = number_integer_;
     }
 
-    virtual void get_float(typename value_type::float_type& out) override
+    void get_float(typename value_type::float_type& out)
     {
         out = is_negative_ ? -number_float_ : number_float_;
     }
 
-    virtual void get_string(typename value_type::string_type& out) override
+    void get_string(typename value_type::string_type& out)
     {
         scan_string(out);
     }
 
-    virtual token_type scan() override
+    // skips a string without keeping its content
+    // on contiguous input only the escapes are recognized, the characters are not validated
+    void skip_string()
     {
-        skip_spaces();
-
-        if (this->is_.eof())
-            return token_type::end_of_input;
+        CONFIGOR_ASSERT(current_ == '\"');
 
-        token_type result = token_type::uninitialized;
-        switch (current_)
+        if (this->buffer_decoder_)
         {
-        case '[':
-            result = token_type::begin_array;
-            break;
-        case ']':
-            result = token_type::end_array;
-            break;
-        case '{':
-            result = token_type::begin_object;
-            break;
-        case '}':
-            result = token_type::end_object;
-            break;
-        case ':':
-            result = token_type::name_separator;
-            break;
-        case ',':
-            result = token_type::value_separator;
-            break;
+            this->buffer_ = skip_raw_string(this->buffer_);
+            read_next();
+            return;
+        }
 
-        case 't':
-            return scan_literal({ 't', 'r', 'u', 'e' }, token_type::literal_true);
-        case 'f':
-            return scan_literal({ 'f', 'a', 'l', 's', 'e' }, token_type::literal_false);
-        case 'n':
-            return scan_literal({ 'n', 'u', 'l', 'l' }, token_type::literal_null);
+        typename value_type::string_type discarded;
+        scan_string(discarded);
+    }
 
-        case '\"':
-            // lazy load
+    // skips the rest of an array or object whose opening bracket was just scanned
+    // by matching brackets on contiguous input, the skipped values are not validated
+    // returns false if the input is not contiguous
+    bool skip_nested()
+    {
+        if (!this->buffer_decoder_)
+            return false;
+
+        if (eof_)
+            fail("unexpected eof");
+
+        if (index_)
+        {
+            // the bracket was the last token read from the index
+            const std::size_t close = index_->find_close(index_pos_ - 1);
+            if (close == index_->size())
+                fail("unexpected eof");
+
+            this->buffer_ = (*index_)[close] + 1;
+            index_pos_    = close + 1;
+            read_next();
+            return true;
+        }
+
+        // non-ascii characters are never encoded with ascii code units
+        const source_char_type* ptr   = this->buffer_;
+        uint32_t                ch    = current_;
+        std::size_t             depth = 1;
+        while (true)
+        {
+            switch (ch)
+            {
+            case '\"':
+                ptr = skip_raw_string(ptr);
+                break;
+            case '/':
+                ptr = skip_raw_comment(ptr);
+                break;
+            case '[':
+            case '{':
+                ++depth;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0)
+                {
+                    this->buffer_ = ptr;
+                    read_next();
+                    return true;
+                }
+                break;
+            default:
+                break;
+            }
+
+            ptr = detail::simd::find_nesting_char(ptr, this->buffer_end_);
+            if (ptr == this->buffer_end_)
+                fail("unexpected eof");
+            ch = static_cast<uint32_t>(*ptr++);
+        }
+    }
+
+    token_type scan()
+    {
+        if (index_)
+        {
+            seek_token();
+        }
+        skip_spaces();
+
+        if (eof_)
+            return token_type::end_of_input;
+
+        token_type result = token_type::uninitialized;
+        switch (current_)
+        {
+        case '[':
+            result = token_type::begin_array;
+            break;
+        case ']':
+            result = token_type::end_array;
+            break;
+        case '{':
+            result = token_type::begin_object;
+            break;
+        case '}':
+            result = token_type::end_object;
+            break;
+        case ':':
+            result = token_type::name_separator;
+            break;
+        case ',':
+            result = token_type::value_separator;
+            break;
+
+        case 't':
+            return scan_literal({ 't', 'r', 'u', 'e' }, token_type::literal_true);
+        case 'f':
+            return scan_literal({ 'f', 'a', 'l', 's', 'e' }, token_type::literal_false);
+        case 'n':
+            return scan_literal({ 'n', 'u', 'l', 'l' }, token_type::literal_null);
+
+        case '\"':
+            // lazy load
             return token_type::value_string;
 
         case '-':
@@ -244,9 +874,87 @@ public:
         return result;
     }
 
+    void set_structural_index(const structural_index<source_char_type>* index)
+    {
+        index_      = nullptr;
+        index_pos_  = 0;
+        owns_index_ = (index == nullptr);
+        if (!this->buffer_decoder_)
+            return;
+
+        if (index == nullptr)
+        {
+            owned_index_.build(this->buffer_, this->buffer_end_);
+            index = &owned_index_;
+        }
+
+        if (index->valid() && index->begin_of_input() == this->buffer_ && index->end_of_input() == this->buffer_end_)
+            index_ = index;
+    }
+
+    // moves to the next token of the structural index
+    // the characters before it must be whitespace, since anything else would have been indexed
+    void seek_token()
+    {
+        const source_char_type* next = this->buffer_end_;
+        if (index_pos_ < index_->size())
+            next = (*index_)[index_pos_++];
+
+        if (!eof_ && position() != next)
+        {
+            if (!simd::is_whitespace(current_))
+                fail("unexpected character", current_);
+
+            this->buffer_ = next;
+            read_next();
+        }
+    }
+
+    // the position of the current character on contiguous input
+    // only valid while the current character is ascii, which holds at the beginning of every token
+    inline const source_char_type* position() const
+    {
+        return eof_ ? this->buffer_ : this->buffer_ - 1;
+    }
+
+    // the input is read to its end, otherwise end_of_input was scanned at a NUL character
+    inline bool eof() const
+    {
+        return eof_;
+    }
+
+    // a control character is invalid in a string, and a NUL character out of a string ends the input
+    static inline bool is_control_char(source_char_type ch)
+    {
+        return static_cast<uint32_t>(static_cast<typename std::make_unsigned<source_char_type>::type>(ch)) < 0x20;
+    }
+
     uint32_t read_next()
     {
-        if (this->source_decoder_(this->is_, current_))
+        if (this->buffer_decoder_)
+        {
+            // contiguous input
+            if (this->buffer_ == this->buffer_end_)
+            {
+                current_ = 0;
+                eof_     = true;
+                return current_;
+            }
+
+            current_ = static_cast<uint32_t>(*this->buffer_);
+            if (current_ < 0x80)
+            {
+                // ASCII
+                ++this->buffer_;
+            }
+            else if (!decode(this->buffer_, this->buffer_end_, current_))
+            {
+                fail("decoding failed with codepoint", current_);
+            }
+            return current_;
+        }
+
+        if (decode(this->is_, current_))
         {
             if (!this->is_.good())
             {
@@ -256,17 +964,30 @@ public:
         else
         {
             current_ = 0;
+            eof_     = true;
         }
         return current_;
     }
 
     void skip_spaces()
     {
-        while (current_ == ' ' || current_ == '\t' || current_ == '\n' || current_ == '\r')
-            read_next();
+        if (this->buffer_decoder_)
+        {
+            // contiguous input
+            if (simd::is_whitespace(current_))
+            {
+                this->buffer_ = simd::skip_whitespace(this->buffer_, this->buffer_end_);
+                read_next();
+            }
+        }
+        else
+        {
+            while (simd::is_whitespace(current_))
+                read_next();
+        }
 
         // skip comments
-        if (current_ == '/')
+        if (traits_type::comments && current_ == '/')
         {
             skip_comments();
         }
@@ -278,6 +999,14 @@ public:
         if (current_ == '/')
         {
             // one line comment
+            if (this->buffer_decoder_)
+            {
+                // contiguous input
+                // line breaks never appear inside a multi-byte sequence, so the comment is not decoded
+                this->buffer_ = simd::find_first_of(this->buffer_, this->buffer_end_, source_char_type('\n'),
+                                                    source_char_type('\r'));
+            }
+
             while (true)
             {
                 read_next();
@@ -288,7 +1017,7 @@ public:
                     break;
                 }
 
-                if (this->is_.eof())
+                if (eof_)
                 {
                     break;
                 }
@@ -297,22 +1026,49 @@ public:
         else if (current_ == '*')
         {
             // multiple line comment
-            while (true)
+            if (this->buffer_decoder_)
             {
-                if (read_next() == '*')
+                // contiguous input
+                while (true)
                 {
-                    if (read_next() == '/')
+                    this->buffer_ = simd::find(this->buffer_, this->buffer_end_, source_char_type('*'));
+                    if (this->buffer_ == this->buffer_end_)
+                    {
+                        fail("unexpected eof while reading comment");
+                    }
+
+                    ++this->buffer_;
+                    if (this->buffer_ != this->buffer_end_ && *this->buffer_ == source_char_type('/'))
                     {
                         // end of comment
+                        ++this->buffer_;
                         read_next();
                         break;
                     }
                 }
+                skip_spaces();
+                return;
+            }
 
-                if (this->is_.eof())
+            read_next();
+            while (true)
+            {
+                if (eof_)
                 {
                     fail("unexpected eof while reading comment");
                 }
+
+                if (current_ == '*')
+                {
+                    if (read_next() == '/')
+                    {
+                        // end of comment
+                        read_next();
+                        break;
+                    }
+                    continue;
+                }
+                read_next();
             }
             skip_spaces();
         }
@@ -345,12 +1101,23 @@ public:
     {
         CONFIGOR_ASSERT(current_ == '\"');
 
-        detail::fast_string_ostreambuf<target_char_type> buf{ out };
-        std::basic_ostream<target_char_type>             oss{ &buf };
+        if (insitu_strings_ && this->buffer_decoder_ && scan_string_view(out, can_view_strings{}))
+        {
+            return;
+        }
+
         while (true)
         {
+            if (this->buffer_decoder_)
+            {
+                // copy the plain ascii characters at once
+                const auto first = this->buffer_;
+                this->buffer_    = detail::simd::skip_plain_string(first, this->buffer_end_);
+                out.append(first, this->buffer_);
+            }
+
             read_next();
-            if (this->is_.eof())
+            if (eof_)
             {
                 fail("unexpected end of string");
             }
@@ -406,28 +1173,28 @@ public:
                 switch (read_next())
                 {
                 case '\"':
-                    oss << '\"';
+                    out.push_back('\"');
                     break;
                 case '\\':
-                    oss << '\\';
+                    out.push_back('\\');
                     break;
                 case '/':
-                    oss << '/';
+                    out.push_back('/');
                     break;
                 case 'b':
-                    oss << '\b';
+                    out.push_back('\b');
                     break;
                 case 'f':
-                    oss << '\f';
+                    out.push_back('\f');
                     break;
                 case 'n':
-                    oss << '\n';
+                    out.push_back('\n');
                     break;
                 case 'r':
-                    oss << '\r';
+                    out.push_back('\r');
                     break;
                 case 't':
-                    oss << '\t';
+                    out.push_back('\t');
                     break;
 
                 case 'u':
@@ -451,11 +1218,7 @@ public:
                         codepoint = encoding::unicode::decode_surrogates(lead_surrogate, trail_surrogate);
                     }
 
-                    this->target_encoder_(oss, codepoint);
-                    if (!oss.good())
-                    {
-                        fail("encoding failed with codepoint", codepoint);
-                    }
+                    put_codepoint(out, codepoint);
                     break;
                 }
 
@@ -469,25 +1232,103 @@ public:
 
             default:
             {
-                this->target_encoder_(oss, current_);
-                if (!oss.good())
-                {
-                    fail("encoding failed with codepoint", current_);
-                }
+                put_codepoint(out, current_);
+            }
+            }
+        }
+    }
+
+    template <typename _StrTy>
+    using assign_view_fn =
+        decltype(std::declval<_StrTy&>().assign_view(std::declval<const target_char_type*>(),
+                                                     std::declval<const target_char_type*>()));
+
+    using can_view_strings = std::integral_constant<
+        bool, std::is_same<source_char_type, target_char_type>::value
+                  && detail::is_detected<assign_view_fn, typename value_type::string_type>::value>;
+
+    bool scan_string_view(typename value_type::string_type&, std::false_type)
+    {
+        return false;
+    }
+
+    // makes `out` refer to the buffer if the string is stored unchanged in it
+    // otherwise copies the characters checked so far and leaves the rest to scan_string
+    bool scan_string_view(typename value_type::string_type& out, std::true_type)
+    {
+        const auto first = this->buffer_;
+        const auto last  = this->buffer_end_;
+
+        auto ptr = first;
+        while (true)
+        {
+            ptr = detail::simd::skip_plain_string(ptr, last);
+            if (ptr == last || *ptr == '\\' || is_control_char(*ptr))
+                break;
+
+            if (*ptr == '\"')
+            {
+                out.assign_view(first, ptr);
+                this->buffer_ = ptr + 1;
+                read_next();
+                return true;
             }
+
+            // non-ASCII characters are kept only if they encode back to the same units
+            const auto seq       = ptr;
+            uint32_t   codepoint = 0;
+            if (!decode(ptr, last, codepoint))
+            {
+                ptr = seq;
+                break;
+            }
+
+            target_char_type buffer[encoding::max_encoded_length];
+            const auto       end = encode(buffer, codepoint);
+            if (end == nullptr || end - buffer != ptr - seq || !std::equal(buffer, end, seq))
+            {
+                ptr = seq;
+                break;
             }
         }
+
+        out.append(first, ptr);
+        this->buffer_ = ptr;
+        return false;
+    }
+
+    void put_codepoint(typename value_type::string_type& out, uint32_t codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out.push_back(static_cast<target_char_type>(codepoint));
+            return;
+        }
+
+        target_char_type buffer[encoding::max_encoded_length];
+        const auto       end = encode(buffer, codepoint);
+        if (end == nullptr)
+        {
+            fail("encoding failed with codepoint", codepoint);
+        }
+        out.append(buffer, end);
     }
 
     token_type scan_number()
     {
         is_negative_    = false;
         number_integer_ = 0;
+        significand_    = 0;
+        exponent_       = 0;
+        digits_         = 0;
+        extra_digits_.clear();
 
         if (current_ == '-' || current_ == '+')
         {
             is_negative_ = (current_ == '-');
             read_next();
+            if (!is_digit(current_))
+                fail("invalid number, expect digit after sign, but got", current_);
         }
 
         if (current_ == '0')
@@ -511,27 +1352,39 @@ public:
 
         CONFIGOR_ASSERT(is_digit(current_));
 
-        number_integer_ = static_cast<integer_type>(current_ - '0');
+        add_digit(current_);
         while (true)
         {
+            add_eight_digits();
+
             const auto ch = read_next();
             if (ch == '.' || ch == 'e' || ch == 'E')
                 return scan_float();
 
             if (is_digit(ch))
-                number_integer_ = number_integer_ * 10 + static_cast<integer_type>(ch - '0');
+                add_digit(ch);
             else
                 break;
         }
+
+        // the magnitude of the min value is one more than the max value
+        const uint64_t max_value = static_cast<uint64_t>((std::numeric_limits<integer_type>::max)());
+        const uint64_t limit =
+            (is_negative_ && std::numeric_limits<integer_type>::is_signed) ? max_value + 1 : max_value;
+        if (!extra_digits_.empty() || significand_ > limit)
+        {
+            if (!integer_promotion_)
+                fail("integer overflow");
+            return make_float();
+        }
+
+        number_integer_ =
+            is_negative_ ? static_cast<integer_type>(0 - significand_) : static_cast<integer_type>(significand_);
         return token_type::value_integer;
     }
 
     token_type scan_float()
     {
-        using float_type = typename value_type::float_type;
-
-        number_float_ = static_cast<float_type>(number_integer_);
-
         if (current_ == 'e' || current_ == 'E')
             return scan_exponent();
 
@@ -540,30 +1393,30 @@ public:
         if (!is_digit(read_next()))
             fail("invalid float number, got", current_);
 
-        float_type fraction = static_cast<float_type>(0.1);
-        number_float_ += static_cast<float_type>(static_cast<uint32_t>(current_ - '0')) * fraction;
+        add_digit(current_);
+        --exponent_;
 
         while (true)
         {
+            exponent_ -= static_cast<int32_t>(add_eight_digits());
+
             const auto ch = read_next();
             if (ch == 'e' || ch == 'E')
                 return scan_exponent();
 
             if (is_digit(ch))
             {
-                fraction *= static_cast<float_type>(0.1);
-                number_float_ += static_cast<float_type>(static_cast<uint32_t>(current_ - '0')) * fraction;
+                add_digit(ch);
+                --exponent_;
             }
             else
                 break;
         }
-        return token_type::value_float;
+        return make_float();
     }
 
     token_type scan_exponent()
     {
-        using float_type = typename value_type::float_type;
-
         CONFIGOR_ASSERT(current_ == 'e' || current_ == 'E');
 
         read_next();
@@ -572,32 +1425,117 @@ public:
         if (!invalid)
             fail("invalid exponent number, got", current_);
 
-        float_type base = 10;
-        if (current_ == '+')
+        bool negative = false;
+        if (current_ == '+' || current_ == '-')
         {
-            read_next();
+            negative = (current_ == '-');
+            if (!is_digit(read_next()))
+                fail("invalid exponent number, got", current_);
         }
-        else if (current_ == '-')
+
+        int32_t exponent = static_cast<int32_t>(current_ - '0');
+        while (is_digit(read_next()))
         {
-            base = static_cast<float_type>(0.1);
-            read_next();
+            // large enough to overflow or underflow every float type
+            if (exponent < 100000)
+                exponent = (exponent * 10) + static_cast<int32_t>(current_ - '0');
         }
 
-        uint32_t exponent = static_cast<uint32_t>(current_ - '0');
-        while (is_digit(read_next()))
+        exponent_ += negative ? -exponent : exponent;
+        return make_float();
+    }
+
+    inline void add_digit(uint32_t ch)
+    {
+        // keep 19 significant digits, which always fit in uint64_t
+        if (digits_ < 19)
+        {
+            significand_ = significand_ * 10 + (ch - '0');
+            if (significand_ != 0)
+                ++digits_;
+        }
+        else
+        {
+            extra_digits_.push_back(static_cast<char>(ch));
+        }
+    }
+
+    // consume digits 8 at a time on contiguous input
+    // returns the count of added digits
+    uint32_t add_eight_digits()
+    {
+        uint32_t count = 0;
+        if (this->buffer_decoder_ && significand_ != 0)
         {
-            exponent = (exponent * 10) + static_cast<uint32_t>(current_ - '0');
+            uint32_t value = 0;
+            while (digits_ + 8 <= 19 && this->buffer_end_ - this->buffer_ >= 8
+                   && detail::simd::read_eight_digits(this->buffer_, value))
+            {
+                significand_ = significand_ * 100000000 + value;
+                digits_ += 8;
+                count += 8;
+                this->buffer_ += 8;
+            }
         }
+        return count;
+    }
 
-        float_type power = 1;
-        for (; exponent; exponent >>= 1, base *= base)
-            if (exponent & 1)
-                power *= base;
+    inline token_type make_float()
+    {
+        using float_type = typename value_type::float_type;
 
-        number_float_ *= power;
+        number_float_ = floating::decimal_to_float<float_type>(significand_, exponent_, extra_digits_);
         return token_type::value_float;
     }
 
+    // returns the position after the closing quote
+    const source_char_type* skip_raw_string(const source_char_type* ptr)
+    {
+        const auto last = this->buffer_end_;
+        while (true)
+        {
+            ptr = detail::simd::find_first_of(ptr, last, source_char_type('\"'), source_char_type('\\'));
+            if (ptr == last)
+                fail("unexpected end of string");
+
+            if (*ptr == source_char_type('\"'))
+                return ptr + 1;
+
+            // skip the escaped character
+            if (last - ptr < 2)
+                fail("unexpected end of string");
+            ptr += 2;
+        }
+    }
+
+    // returns the position after the comment
+    const source_char_type* skip_raw_comment(const source_char_type* ptr)
+    {
+        const auto last = this->buffer_end_;
+        if (traits_type::comments && ptr != last && *ptr == source_char_type('/'))
+        {
+            return detail::simd::find_first_of(ptr + 1, last, source_char_type('\n'), source_char_type('\r'));
+        }
+
+        if (traits_type::comments && ptr != last && *ptr == source_char_type('*'))
+        {
+            ++ptr;
+            while (true)
+            {
+                ptr = detail::simd::find(ptr, last, source_char_type('*'));
+                if (ptr == last)
+                    fail("unexpected eof while reading comment");
+
+                ++ptr;
+                if (ptr != last && *ptr == source_char_type('/'))
+                    return ptr + 1;
+            }
+        }
+
+        fail("unexpected character '/'");
+        return last;
+    }
+
     uint32_t read_escaped_codepoint()
     {
         uint32_t code = 0;
@@ -624,66 +1562,1940 @@ public:
         return code;
     }
 
-    inline bool is_digit(source_char_type ch) const
-    {
-        return source_char_type('0') <= ch && ch <= source_char_type('9');
-    }
+    // the encodings of the traits replace the encodings set at runtime
+    template <template <class> class _Encoding>
+    struct traits_encoding
+    {
+        template <typename _CharTy>
+        using source = typename std::conditional<
+            std::is_void<typename traits_type::template source_encoding<_CharTy>>::value, _Encoding<_CharTy>,
+            typename traits_type::template source_encoding<_CharTy>>::type;
+
+        template <typename _CharTy>
+        using target = typename std::conditional<
+            std::is_void<typename traits_type::template target_encoding<_CharTy>>::value, _Encoding<_CharTy>,
+            typename traits_type::template target_encoding<_CharTy>>::type;
+    };
+
+    using source_encoding_type = typename traits_type::template source_encoding<source_char_type>;
+    using target_encoding_type = typename traits_type::template target_encoding<target_char_type>;
+
+    inline bool decode(const source_char_type*& first, const source_char_type* last, uint32_t& codepoint)
+    {
+        return decode(first, last, codepoint, encoding::is_buffer_decodable<source_encoding_type, source_char_type>{});
+    }
+
+    inline bool decode(const source_char_type*& first, const source_char_type* last, uint32_t& codepoint,
+                       std::true_type)
+    {
+        return source_encoding_type::decode(first, last, codepoint);
+    }
+
+    inline bool decode(const source_char_type*& first, const source_char_type* last, uint32_t& codepoint,
+                       std::false_type)
+    {
+        return this->buffer_decoder_(first, last, codepoint);
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint)
+    {
+        return decode(is, codepoint, std::integral_constant<bool, !std::is_void<source_encoding_type>::value>{});
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint, std::true_type)
+    {
+        return source_encoding_type::decode(is, codepoint);
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint, std::false_type)
+    {
+        return this->source_decoder_(is, codepoint);
+    }
+
+    inline target_char_type* encode(target_char_type* out, uint32_t codepoint)
+    {
+        return encode(out, codepoint, encoding::is_buffer_encodable<target_encoding_type, target_char_type>{});
+    }
+
+    inline target_char_type* encode(target_char_type* out, uint32_t codepoint, std::true_type)
+    {
+        return target_encoding_type::encode(out, codepoint);
+    }
+
+    inline target_char_type* encode(target_char_type* out, uint32_t codepoint, std::false_type)
+    {
+        return this->target_encoder_(out, codepoint);
+    }
+
+    inline bool is_digit(source_char_type ch) const
+    {
+        return source_char_type('0') <= ch && ch <= source_char_type('9');
+    }
+
+    inline void fail(const std::string& msg)
+    {
+        throw configor_deserialization_error(msg);
+    }
+
+    template <typename _IntTy>
+    inline void fail(const std::string& msg, _IntTy code)
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << make_json_hex(code) << "'";
+        fail(ss.str());
+    }
+
+private:
+    bool                                      is_negative_;
+    bool                                      integer_promotion_;
+    bool                                      insitu_strings_;
+    const structural_index<source_char_type>* index_;
+    std::size_t                               index_pos_;
+    structural_index<source_char_type>        owned_index_;
+    bool                                      owns_index_;
+    bool                                      eof_;
+    uint32_t                                  current_;
+    typename value_type::integer_type         number_integer_;
+    typename value_type::float_type           number_float_;
+    uint64_t                                  significand_;
+    int32_t                                   exponent_;
+    uint32_t                                  digits_;
+    std::string                               extra_digits_;
+};
+
+//
+// json_reader
+// a cursor over the tokens of a json document, separators are checked and skipped
+//
+// keys are returned as value_string tokens, and a string is only read if get_string is called
+// errors are always thrown, error handlers are ignored
+//
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_reader
+{
+public:
+    using value_type       = _ValTy;
+    using source_char_type = _SourceCharTy;
+    using parser_type      = json_parser<value_type, source_char_type>;
+    using option           = typename parser_type::option;
+    using integer_type     = typename value_type::integer_type;
+    using float_type       = typename value_type::float_type;
+    using string_type      = typename value_type::string_type;
+
+    explicit json_reader(std::basic_istream<source_char_type>& is, std::initializer_list<option> options = {})
+        : parser_(is)
+        , token_(token_type::uninitialized)
+        , string_read_(false)
+        , string_()
+        , stack_()
+    {
+        prepare(options);
+    }
+
+    explicit json_reader(const std::basic_string<source_char_type>& str, std::initializer_list<option> options = {})
+        : json_reader(str.data(), str.size(), options)
+    {
+    }
+
+    explicit json_reader(const source_char_type* str, std::initializer_list<option> options = {})
+        : json_reader(str, std::char_traits<source_char_type>::length(str), options)
+    {
+    }
+
+    // the buffer must outlive the reader
+    template <typename _SizeTy, typename = typename std::enable_if<std::is_integral<_SizeTy>::value>::type>
+    json_reader(const source_char_type* buffer, _SizeTy size, std::initializer_list<option> options = {})
+        : parser_(buffer, buffer + static_cast<std::size_t>(size))
+        , token_(token_type::uninitialized)
+        , string_read_(false)
+        , string_()
+        , stack_()
+    {
+        prepare(options);
+    }
+
+    // reads the next token
+    // end_of_input is returned after the whole document is read
+    token_type next()
+    {
+        if (token_ == token_type::value_string && !string_read_)
+            parser_.skip_string();
+        string_read_ = false;
+
+        token_type token = parser_.scan();
+        if (stack_.empty())
+        {
+            if (token_ == token_type::uninitialized)
+                return enter(token);
+
+            if (token != token_type::end_of_input)
+                fail(token, token_type::end_of_input);
+            return token_ = token;
+        }
+
+        switch (stack_.back())
+        {
+        case state::array_first:
+            if (token == token_type::end_array)
+                return leave(token);
+            break;
+
+        case state::array_next:
+            if (token == token_type::value_separator)
+                token = parser_.scan();
+            else if (token != token_type::end_array)
+                fail(token, token_type::end_array);
+
+            if (token == token_type::end_array)
+                return leave(token);
+            break;
+
+        case state::object_next:
+            if (token == token_type::value_separator)
+                token = parser_.scan();
+            else if (token != token_type::end_object)
+                fail(token, token_type::end_object);
+            // fall through
+
+        case state::object_first:
+            if (token == token_type::end_object)
+                return leave(token);
+
+            if (token != token_type::value_string)
+                fail(token, token_type::end_object);
+
+            // key
+            stack_.back() = state::object_value;
+            return token_ = token;
+
+        case state::object_value:
+            if (token != token_type::name_separator)
+                fail(token, token_type::name_separator);
+
+            token         = parser_.scan();
+            stack_.back() = state::object_next;
+            return enter(token);
+        }
+
+        stack_.back() = state::array_next;
+        return enter(token);
+    }
+
+    // returns the current token
+    inline token_type token() const
+    {
+        return token_;
+    }
+
+    // returns true if the current token is the key of a member
+    inline bool is_key() const
+    {
+        return token_ == token_type::value_string && !stack_.empty() && stack_.back() == state::object_value;
+    }
+
+    // returns the count of arrays and objects containing the current token
+    inline std::size_t depth() const
+    {
+        return (token_ == token_type::begin_array || token_ == token_type::begin_object) ? stack_.size() - 1
+                                                                                             : stack_.size();
+    }
+
+    // reads the current string or key, the result is valid until the next token
+    const string_type& get_string()
+    {
+        if (token_ != token_type::value_string)
+            fail(token_, token_type::value_string);
+
+        if (!string_read_)
+        {
+            string_.clear();
+            parser_.get_string(string_);
+            string_read_ = true;
+        }
+        return string_;
+    }
+
+    integer_type get_integer()
+    {
+        if (token_ != token_type::value_integer)
+            fail(token_, token_type::value_integer);
+
+        integer_type i{};
+        parser_.get_integer(i);
+        return i;
+    }
+
+    // integers are converted to float
+    float_type get_float()
+    {
+        if (token_ == token_type::value_integer)
+            return static_cast<float_type>(get_integer());
+
+        if (token_ != token_type::value_float)
+            fail(token_, token_type::value_float);
+
+        float_type f{};
+        parser_.get_float(f);
+        return f;
+    }
+
+    bool get_boolean()
+    {
+        if (token_ != token_type::literal_true && token_ != token_type::literal_false)
+            fail(token_, token_type::literal_true);
+        return token_ == token_type::literal_true;
+    }
+
+    // skips the current value, or the value of the current key
+    // afterwards the current token is the last token of the skipped value
+    void skip_value()
+    {
+        if (is_key())
+        {
+            next();
+        }
+
+        if (token_ != token_type::begin_array && token_ != token_type::begin_object)
+            return;
+
+        const token_type end_token =
+            (token_ == token_type::begin_array) ? token_type::end_array : token_type::end_object;
+        if (parser_.skip_nested())
+        {
+            stack_.pop_back();
+            token_ = end_token;
+            return;
+        }
+
+        const std::size_t depth = stack_.size();
+        while (stack_.size() >= depth)
+            next();
+    }
+
+    // builds the current value, or the value of the current key
+    // afterwards the current token is the last token of the value
+    void read_value(value_type& out)
+    {
+        if (is_key())
+        {
+            next();
+        }
+
+        value_builder<value_type> builder{ out };
+        std::size_t               depth = 0;
+        while (true)
+        {
+            switch (token_)
+            {
+            case token_type::begin_object:
+                builder.start_object();
+                ++depth;
+                break;
+            case token_type::end_object:
+                builder.end_object();
+                --depth;
+                break;
+            case token_type::begin_array:
+                builder.start_array();
+                ++depth;
+                break;
+            case token_type::end_array:
+                builder.end_array();
+                --depth;
+                break;
+            case token_type::value_string:
+            {
+                string_type s = get_string();
+                if (is_key())
+                    builder.key(s);
+                else
+                    builder.string(s);
+                break;
+            }
+            case token_type::value_integer:
+                builder.integer(get_integer());
+                break;
+            case token_type::value_float:
+                builder.floating(get_float());
+                break;
+            case token_type::literal_true:
+            case token_type::literal_false:
+                builder.boolean(get_boolean());
+                break;
+            case token_type::literal_null:
+                builder.null();
+                break;
+            default:
+                break;
+            }
+
+            if (depth == 0 && !is_key())
+                return;
+            next();
+        }
+    }
+
+private:
+    enum class state : uint8_t
+    {
+        array_first,
+        array_next,
+        object_first,
+        object_value,
+        object_next,
+    };
+
+    void prepare(std::initializer_list<option> options)
+    {
+        parser_.template set_source_encoding<_DefaultEncoding>();
+        parser_.template set_target_encoding<_DefaultEncoding>();
+        parser_.prepare(options);
+
+        // read first char
+        parser_.read_next();
+    }
+
+    token_type enter(token_type token)
+    {
+        switch (token)
+        {
+        case token_type::begin_array:
+        case token_type::begin_object:
+            if (stack_.size() >= parser_.get_max_depth())
+                throw configor_deserialization_error("exceeded max depth");
+            stack_.push_back(token == token_type::begin_array ? state::array_first : state::object_first);
+            break;
+        case token_type::literal_true:
+        case token_type::literal_false:
+        case token_type::literal_null:
+        case token_type::value_string:
+        case token_type::value_integer:
+        case token_type::value_float:
+            break;
+        default:
+            fail(token);
+            break;
+        }
+        return token_ = token;
+    }
+
+    token_type leave(token_type token)
+    {
+        stack_.pop_back();
+        return token_ = token;
+    }
+
+    void fail(token_type actual_token, const std::string& msg = "unexpected token")
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << to_string(actual_token) << "'";
+        throw configor_deserialization_error(ss.str());
+    }
+
+    void fail(token_type actual_token, token_type expected_token, const std::string& msg = "unexpected token")
+    {
+        fail(actual_token, msg + ", expect '" + to_string(expected_token) + "', but got");
+    }
+
+private:
+    parser_type        parser_;
+    token_type         token_;
+    bool               string_read_;
+    string_type        string_;
+    std::vector<state> stack_;
+};
+
+//
+// json_push_parser
+// an incremental parser fed with chunks of a json document, events are sent to a sax handler
+// as soon as the tokens are complete, so parsing overlaps with receiving the input
+// errors are always thrown, error handlers are ignored, and the parser cannot be used afterwards
+// input is accepted and rejected like json::parse, a NUL character ends the document
+//
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_push_parser
+{
+public:
+    using value_type       = _ValTy;
+    using source_char_type = _SourceCharTy;
+    using parser_type      = json_parser<value_type, source_char_type>;
+    using option           = typename parser_type::option;
+    using handler_type     = basic_sax_handler<value_type>;
+    using string_type      = typename value_type::string_type;
+
+    // builds a value, see value()
+    explicit json_push_parser(std::initializer_list<option> options = {})
+        : json_push_parser(nullptr, options)
+    {
+    }
+
+    // the handler must outlive the parser
+    explicit json_push_parser(handler_type& handler, std::initializer_list<option> options = {})
+        : json_push_parser(&handler, options)
+    {
+    }
+
+    json_push_parser(const json_push_parser&) = delete;
+    json_push_parser& operator=(const json_push_parser&) = delete;
+
+    // parses the complete tokens of the chunk, an incomplete token at the end is kept until the next chunk
+    // returns true once the document is complete or the handler stopped parsing
+    bool feed(const source_char_type* data, std::size_t size)
+    {
+        if (stopped_)
+            return true;
+
+        pending_.append(data, size);
+        frame();
+        parse_pending(safe_);
+        return done();
+    }
+
+    bool feed(const std::basic_string<source_char_type>& chunk)
+    {
+        return feed(chunk.data(), chunk.size());
+    }
+
+    // parses the rest of the input, throws if the document is incomplete
+    void finish()
+    {
+        if (stopped_)
+            return;
+
+        parse_pending(pending_.size());
+        if (!complete_)
+            fail(token_type::end_of_input);
+    }
+
+    // returns true once the document is complete or the handler stopped parsing
+    inline bool done() const
+    {
+        return complete_ || stopped_;
+    }
+
+    // the value built without a handler
+    inline value_type& value()
+    {
+        return value_;
+    }
+
+private:
+    enum class state : uint8_t
+    {
+        array_first,
+        array_next,
+        array_value,
+        object_first,
+        object_key,
+        object_colon,
+        object_value,
+        object_next,
+    };
+
+    // the kind of the token being framed when the input ended
+    enum class partial : uint8_t
+    {
+        none,
+        string,
+        string_escape,
+        scalar,
+        sequence,
+        comment,
+        line_comment,
+        block_comment,
+        block_comment_star,
+    };
+
+    // the parser is configured once and reset to each chunk
+    json_push_parser(handler_type* handler, std::initializer_list<option> options)
+        : parser_(nullptr, nullptr)
+        , value_()
+        , builder_(value_)
+        , handler_(handler ? handler : &builder_)
+        , pending_()
+        , scan_(0)
+        , safe_(0)
+        , partial_(partial::none)
+        , sequence_(0)
+        , resume_(partial::none)
+        , complete_(false)
+        , stopped_(false)
+        , string_()
+        , stack_()
+    {
+        parser_.template set_source_encoding<_DefaultEncoding>();
+        parser_.template set_target_encoding<_DefaultEncoding>();
+        parser_.prepare(options);
+        // strings cannot refer to the pending input, which is erased once it is parsed
+        parser_.set_insitu_strings(false);
+    }
+
+    // finds the end of the last complete token in the pending input
+    void frame()
+    {
+        const source_char_type* data = pending_.data();
+        const std::size_t       size = pending_.size();
+
+        std::size_t pos = scan_;
+        while (pos < size)
+        {
+            const auto ch = data[pos];
+            switch (partial_)
+            {
+            case partial::none:
+                if (ch == '\"')
+                    partial_ = partial::string;
+                else if (ch == '/')
+                    partial_ = partial::comment;
+                else if (is_scalar_char(ch))
+                    partial_ = partial::scalar;
+
+                ++pos;
+                if (partial_ == partial::none)
+                    safe_ = pos;
+                else if (partial_ == partial::scalar)
+                    skip_sequence(ch);
+                break;
+
+            case partial::string:
+                pos = find_string_char(data, pos, size);
+                if (pos < size)
+                {
+                    if (data[pos] == '\"' || parser_type::is_control_char(data[pos]))
+                    {
+                        // the end of the string, or an invalid character reported by the parser right away
+                        partial_ = partial::none;
+                        safe_    = pos + 1;
+                    }
+                    else if (data[pos] == '\\')
+                    {
+                        partial_ = partial::string_escape;
+                    }
+                    else
+                    {
+                        skip_sequence(data[pos]);
+                    }
+                    ++pos;
+                }
+                break;
+
+            case partial::string_escape:
+                partial_ = partial::string;
+                ++pos;
+                skip_sequence(ch);
+                break;
+
+
+            case partial::scalar:
+                if (is_scalar_char(ch))
+                {
+                    ++pos;
+                    skip_sequence(ch);
+                }
+                else
+                {
+                    // the delimiter is framed as the next token
+                    partial_ = partial::none;
+                    safe_    = pos;
+                }
+                break;
+
+            case partial::sequence:
+                if (--sequence_ == 0)
+                    partial_ = resume_;
+                ++pos;
+                break;
+
+            case partial::comment:
+                if (ch == '/' || ch == '*')
+                {
+                    partial_ = (ch == '/') ? partial::line_comment : partial::block_comment;
+                    ++pos;
+                }
+                else
+                {
+                    // not a comment, left to the parser to report
+                    partial_ = partial::none;
+                    safe_    = pos;
+                }
+                break;
+
+            case partial::line_comment:
+                pos = static_cast<std::size_t>(
+                    simd::find_first_of(data + pos, data + size, source_char_type('\n'), source_char_type('\r'))
+                    - data);
+                if (pos < size)
+                {
+                    partial_ = partial::none;
+                    safe_    = ++pos;
+                }
+                break;
+
+            case partial::block_comment:
+                pos = static_cast<std::size_t>(simd::find(data + pos, data + size, source_char_type('*')) - data);
+                if (pos < size)
+                {
+                    partial_ = partial::block_comment_star;
+                    ++pos;
+                }
+                break;
+
+            case partial::block_comment_star:
+                if (ch == '/')
+                {
+                    partial_ = partial::none;
+                    safe_    = pos + 1;
+                }
+                else if (ch != '*')
+                {
+                    partial_ = partial::block_comment;
+                }
+                ++pos;
+                break;
+            }
+        }
+        scan_ = pos;
+    }
+
+    // finds the quote, backslash or control character in a string, or a lead byte of a UTF-8 sequence
+    // the decoder of the parser reads the bytes of a sequence whatever they are, so they cannot end the string
+    std::size_t find_string_char(const source_char_type* data, std::size_t pos, std::size_t size) const
+    {
+        const bool utf8 = parser_.is_source_utf8();
+        while (true)
+        {
+            pos = static_cast<std::size_t>(simd::skip_plain_string(data + pos, data + size) - data);
+            if (pos == size || data[pos] == '\"' || data[pos] == '\\' || parser_type::is_control_char(data[pos])
+                || (utf8 && utf8_extra_bytes(data[pos])))
+                return pos;
+            ++pos;
+        }
+    }
+
+    // the bytes after a UTF-8 lead byte in a string or scalar belong to the same token
+    void skip_sequence(source_char_type ch)
+    {
+        if (!parser_.is_source_utf8())
+            return;
+
+        sequence_ = utf8_extra_bytes(ch);
+        if (sequence_)
+        {
+            resume_  = partial_;
+            partial_ = partial::sequence;
+        }
+    }
+
+    static uint8_t utf8_extra_bytes(source_char_type ch)
+    {
+        const auto byte = static_cast<uint32_t>(static_cast<typename std::make_unsigned<source_char_type>::type>(ch));
+        if (byte < 0xC0)
+            return 0;
+        return (byte < 0xE0) ? 1 : (byte < 0xF0) ? 2 : (byte < 0xF8) ? 3 : (byte < 0xFC) ? 4 : 5;
+    }
+
+    // whitespace and NUL characters are control characters, which end a scalar like in the parser
+    static bool is_scalar_char(source_char_type ch)
+    {
+        if (parser_type::is_control_char(ch))
+            return false;
+
+        switch (ch)
+        {
+        case ' ':
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case ',':
+        case ':':
+        case '\"':
+        case '/':
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    // parses the pending input up to `end` which must be a token boundary
+    void parse_pending(std::size_t end)
+    {
+        if (end == 0)
+            return;
+
+        parser_.reset(pending_.data(), pending_.data() + end);
+        parser_.read_next();
+
+        while (!stopped_)
+        {
+            const token_type token = parser_.scan();
+            if (token == token_type::end_of_input)
+            {
+                if (!parser_.eof())
+                    end_at_nul();
+                break;
+            }
+            next(token, parser_);
+        }
+
+        pending_.erase(0, end);
+        scan_ -= end;
+        safe_ = 0;
+        if (pending_.empty())
+            partial_ = partial::none;
+    }
+
+    void next(token_type token, parser_type& p)
+    {
+        if (stack_.empty())
+        {
+            if (complete_)
+                fail(token, token_type::end_of_input);
+            value(token, p);
+            return;
+        }
+
+        switch (stack_.back())
+        {
+        case state::array_next:
+            if (token == token_type::value_separator)
+            {
+                stack_.back() = state::array_value;
+                return;
+            }
+            if (token != token_type::end_array)
+                fail(token, token_type::end_array);
+            // fall through
+
+        case state::array_first:
+        case state::array_value:
+            if (token == token_type::end_array)
+            {
+                leave(handler_->end_array());
+                return;
+            }
+            stack_.back() = state::array_next;
+            value(token, p);
+            return;
+
+        case state::object_next:
+            if (token == token_type::value_separator)
+            {
+                stack_.back() = state::object_key;
+                return;
+            }
+            if (token != token_type::end_object)
+                fail(token, token_type::end_object);
+            // fall through
+
+        case state::object_first:
+        case state::object_key:
+            if (token == token_type::end_object)
+            {
+                leave(handler_->end_object());
+                return;
+            }
+            if (token != token_type::value_string)
+                fail(token, token_type::end_object);
+
+            string_.clear();
+            p.get_key(string_);
+            stack_.back() = state::object_colon;
+            stopped_      = !handler_->key(string_);
+            return;
+
+        case state::object_colon:
+            if (token != token_type::name_separator)
+                fail(token, token_type::name_separator);
+            stack_.back() = state::object_value;
+            return;
+
+        case state::object_value:
+            stack_.back() = state::object_next;
+            value(token, p);
+            return;
+        }
+    }
+
+    void value(token_type token, parser_type& p)
+    {
+        bool result = true;
+        switch (token)
+        {
+        case token_type::begin_array:
+        case token_type::begin_object:
+            if (stack_.size() >= p.get_max_depth())
+                throw configor_deserialization_error("exceeded max depth");
+
+            if (token == token_type::begin_array)
+            {
+                stack_.push_back(state::array_first);
+                stopped_ = !handler_->start_array();
+            }
+            else
+            {
+                stack_.push_back(state::object_first);
+                stopped_ = !handler_->start_object();
+            }
+            return;
+
+        case token_type::literal_true:
+            result = handler_->boolean(true);
+            break;
+        case token_type::literal_false:
+            result = handler_->boolean(false);
+            break;
+        case token_type::literal_null:
+            result = handler_->null();
+            break;
+
+        case token_type::value_string:
+            string_.clear();
+            p.get_string(string_);
+            result = handler_->string(string_);
+            break;
+
+        case token_type::value_integer:
+        {
+            typename value_type::integer_type i{};
+            p.get_integer(i);
+            result = handler_->integer(i);
+            break;
+        }
+
+        case token_type::value_float:
+        {
+            typename value_type::float_type f{};
+            p.get_float(f);
+            result = handler_->floating(f);
+            break;
+        }
+
+        default:
+            fail(token);
+            break;
+        }
+
+        stopped_  = !result;
+        complete_ = stack_.empty();
+    }
+
+    void leave(bool result)
+    {
+        stack_.pop_back();
+        stopped_  = !result;
+        complete_ = stack_.empty();
+    }
+
+    // a NUL character ends the input like in the eager parser, which fails before the document is complete
+    // and ignores the rest of the input otherwise
+    void end_at_nul()
+    {
+        if (!complete_)
+            next(token_type::end_of_input, parser_);
+        stopped_ = true;
+    }
+
+    void fail(token_type actual_token, const std::string& msg = "unexpected token")
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << to_string(actual_token) << "'";
+        throw configor_deserialization_error(ss.str());
+    }
+
+    void fail(token_type actual_token, token_type expected_token, const std::string& msg = "unexpected token")
+    {
+        fail(actual_token, msg + ", expect '" + to_string(expected_token) + "', but got");
+    }
+
+private:
+    parser_type                         parser_;
+    value_type                          value_;
+    value_builder<value_type>           builder_;
+    handler_type*                       handler_;
+    std::basic_string<source_char_type> pending_;
+    std::size_t                         scan_;
+    std::size_t                         safe_;
+    partial                             partial_;
+    uint8_t                             sequence_;
+    partial                             resume_;
+    bool                                complete_;
+    bool                                stopped_;
+    string_type                         string_;
+    std::vector<state>                  stack_;
+};
+
+//
+// json_lazy_value
+// a value in a buffer which is only scanned when accessed, members and elements are found by skipping
+// their siblings without building them, and only the values requested by get() are parsed
+// the first token of the value is scanned once when the value is found
+// the options given as types are applied to the parser, comments are skipped only if its traits allow them
+//
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding, typename _OptionsTy>
+class json_lazy_value
+{
+public:
+    using value_type       = _ValTy;
+    using source_char_type = _SourceCharTy;
+    using parser_type      = typename json_parser<value_type, source_char_type>::template rebind_options<_OptionsTy>;
+    using option           = typename parser_type::option;
+    using string_type      = typename value_type::string_type;
+    using size_type        = std::size_t;
+
+    // the document is the buffer from `first` to `last`, only whitespace and comments may follow the value
+    // the bracket matching of arrays and objects is checked here, their content when they are accessed
+    // the options are used by materialize() and get()
+    json_lazy_value(const source_char_type* first, const source_char_type* last,
+                    std::initializer_list<option> options = {})
+        : json_lazy_value(first, last,
+                          options.size() ? std::make_shared<const std::vector<option>>(options) : nullptr)
+    {
+        const source_char_type* ptr   = skip_spaces(begin_ + raw().size(), last_);
+        const token_type        token = peek(ptr);
+        if (token != token_type::end_of_input)
+            fail(token, token_type::end_of_input);
+    }
+
+    value_constant::type type() const
+    {
+        switch (token_)
+        {
+        case token_type::begin_object:
+            return value_constant::object;
+        case token_type::begin_array:
+            return value_constant::array;
+        case token_type::value_string:
+            return value_constant::string;
+        case token_type::value_integer:
+            // a long integer may be promoted to a float, which is left to the parser
+            if (next_ - begin_ > std::numeric_limits<typename value_type::integer_type>::digits10)
+                return materialize().type();
+            return value_constant::integer;
+        case token_type::value_float:
+            return value_constant::floating;
+        case token_type::literal_true:
+        case token_type::literal_false:
+            return value_constant::boolean;
+        case token_type::literal_null:
+            return value_constant::null;
+        default:
+            fail(token_);
+            return value_constant::null;
+        }
+    }
+
+    inline bool is_object() const
+    {
+        return token_ == token_type::begin_object;
+    }
+
+    inline bool is_array() const
+    {
+        return token_ == token_type::begin_array;
+    }
+
+    inline bool is_string() const
+    {
+        return token_ == token_type::value_string;
+    }
+
+    inline bool is_null() const
+    {
+        return token_ == token_type::literal_null;
+    }
+
+    // finds the first member with the key
+    json_lazy_value at(const string_type& key) const
+    {
+        if (token_ != token_type::begin_object)
+            throw configor_invalid_key("at() called on a non-object value");
+
+        const source_char_type* ptr = skip_spaces(next_, last_);
+        while (!is_end(ptr, '}', token_type::end_object))
+        {
+            if (*ptr != '\"')
+                fail(peek(ptr), token_type::end_object);
+
+            const source_char_type* name = ptr;
+            ptr                          = skip_string(ptr, last_);
+            const bool found             = equals(name, ptr, key);
+
+            ptr = skip_spaces(ptr, last_);
+            if (ptr == last_ || *ptr != ':')
+                fail(peek(ptr), token_type::name_separator);
+
+            ptr = skip_spaces(ptr + 1, last_);
+            if (found)
+                return json_lazy_value(ptr, last_, options_);
+
+            ptr = next(skip_value(ptr, last_), '}', token_type::end_object);
+        }
+        throw std::out_of_range("at() key out of range");
+    }
+
+    template <typename _CharTy>
+    json_lazy_value at(_CharTy* key) const
+    {
+        return at(string_type(key));
+    }
+
+    json_lazy_value at(size_type index) const
+    {
+        if (token_ != token_type::begin_array)
+            throw configor_invalid_key("at() called on a non-array value");
+
+        const source_char_type* ptr = skip_spaces(next_, last_);
+        for (size_type i = 0; !is_end(ptr, ']', token_type::end_array); ++i)
+        {
+            if (i == index)
+                return json_lazy_value(ptr, last_, options_);
+
+            ptr = next(skip_value(ptr, last_), ']', token_type::end_array);
+        }
+        throw std::out_of_range("at() index out of range");
+    }
+
+    inline json_lazy_value operator[](const string_type& key) const
+    {
+        return at(key);
+    }
+
+    template <typename _CharTy>
+    inline json_lazy_value operator[](_CharTy* key) const
+    {
+        return at(string_type(key));
+    }
+
+    inline json_lazy_value operator[](size_type index) const
+    {
+        return at(index);
+    }
+
+    // counts the members or elements by skipping them
+    size_type size() const
+    {
+        if (token_ != token_type::begin_array && token_ != token_type::begin_object)
+            throw configor_invalid_key("size() called on a non-array or non-object value");
+
+        const bool              is_obj   = (token_ == token_type::begin_object);
+        const source_char_type  end_char = is_obj ? '}' : ']';
+        const token_type        end      = is_obj ? token_type::end_object : token_type::end_array;
+        const source_char_type* ptr      = skip_spaces(next_, last_);
+        size_type               count    = 0;
+        while (!is_end(ptr, end_char, end))
+        {
+            if (is_obj)
+            {
+                if (*ptr != '\"')
+                    fail(peek(ptr), token_type::end_object);
+
+                ptr = skip_spaces(skip_string(ptr, last_), last_);
+                if (ptr == last_ || *ptr != ':')
+                    fail(peek(ptr), token_type::name_separator);
+                ptr = skip_spaces(ptr + 1, last_);
+            }
+
+            ptr = next(skip_value(ptr, last_), end_char, end);
+            ++count;
+        }
+        return count;
+    }
+
+    // the characters of the value
+    basic_string_view<source_char_type> raw() const
+    {
+        const source_char_type* end = next_;
+        switch (token_)
+        {
+        case token_type::begin_array:
+        case token_type::begin_object:
+            end = skip_nested(next_, last_);
+            break;
+        case token_type::value_string:
+        case token_type::value_integer:
+        case token_type::value_float:
+        case token_type::literal_true:
+        case token_type::literal_false:
+        case token_type::literal_null:
+            break;
+        default:
+            fail(token_);
+            break;
+        }
+        return basic_string_view<source_char_type>(begin_, static_cast<std::size_t>(end - begin_));
+    }
+
+    // parses the value and its children with the options given to lazy_parse
+    value_type materialize() const
+    {
+        const auto str = raw();
+
+        value_type  v;
+        parser_type p{ str.data(), str.data() + str.size() };
+        prepare(p);
+        p.parse(v);
+        return v;
+    }
+
+    template <typename _Ty>
+    _Ty get() const
+    {
+        return materialize().template get<_Ty>();
+    }
+
+private:
+    using options_type = std::shared_ptr<const std::vector<option>>;
+
+    // a member or element, anything after it up to `last` is ignored
+    json_lazy_value(const source_char_type* first, const source_char_type* last, options_type options)
+        : begin_(skip_spaces(first, last))
+        , next_(begin_)
+        , last_(last)
+        , token_(scan(next_, last))
+        , options_(std::move(options))
+    {
+    }
+
+    void prepare(parser_type& p) const
+    {
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        _OptionsTy::apply_parser(p);
+        if (options_)
+        {
+            for (const auto& option : *options_)
+                option(p);
+        }
+    }
+
+    // compares the key with a name, plain ascii names are compared in place and others are decoded by the parser
+    bool equals(const source_char_type* first, const source_char_type* last, const string_type& key) const
+    {
+        const size_type size = static_cast<size_type>(last - first) - 2;
+
+        bool plain = true;
+        for (auto ptr = first + 1; plain && ptr != last - 1; ++ptr)
+            plain = (static_cast<uint32_t>(*ptr) < 0x80 && *ptr != '\\');
+
+        if (plain)
+        {
+            if (key.size() != size)
+                return false;
+            for (size_type i = 0; i < size; ++i)
+            {
+                if (static_cast<uint32_t>(key[i]) != static_cast<uint32_t>(first[i + 1]))
+                    return false;
+            }
+            return true;
+        }
+
+        string_type name;
+        parser_type p{ first, last };
+        p.template set_source_encoding<_DefaultEncoding>();
+        p.template set_target_encoding<_DefaultEncoding>();
+        p.read_next();
+        p.get_string(name);
+        return name == key;
+    }
+
+    // moves past the separator after a member or element, a trailing separator is allowed
+    const source_char_type* next(const source_char_type* ptr, source_char_type end_char, token_type end) const
+    {
+        ptr = skip_spaces(ptr, last_);
+        if (ptr != last_ && *ptr == ',')
+            return skip_spaces(ptr + 1, last_);
+        if (ptr == last_ || *ptr != end_char)
+            fail(peek(ptr), end);
+        return ptr;
+    }
+
+    bool is_end(const source_char_type* ptr, source_char_type end_char, token_type end) const
+    {
+        if (ptr == last_)
+            fail(token_type::end_of_input, end);
+        return *ptr == end_char;
+    }
+
+    token_type peek(const source_char_type* ptr) const
+    {
+        return scan(ptr, last_);
+    }
+
+    // the scanner works on the characters, non-ascii characters are never encoded with ascii code units
+
+    // scans the token at `ptr` and moves past it, arrays and objects are only opened
+    static token_type scan(const source_char_type*& ptr, const source_char_type* last)
+    {
+        if (ptr == last)
+            return token_type::end_of_input;
+
+        switch (*ptr)
+        {
+        case '[':
+            ++ptr;
+            return token_type::begin_array;
+        case ']':
+            ++ptr;
+            return token_type::end_array;
+        case '{':
+            ++ptr;
+            return token_type::begin_object;
+        case '}':
+            ++ptr;
+            return token_type::end_object;
+        case ':':
+            ++ptr;
+            return token_type::name_separator;
+        case ',':
+            ++ptr;
+            return token_type::value_separator;
+
+        case 't':
+            return scan_literal(ptr, last, "true", token_type::literal_true);
+        case 'f':
+            return scan_literal(ptr, last, "false", token_type::literal_false);
+        case 'n':
+            return scan_literal(ptr, last, "null", token_type::literal_null);
+
+        case '\"':
+            ptr = skip_string(ptr, last);
+            return token_type::value_string;
+
+        case '-':
+        case '+':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return scan_number(ptr, last);
+
+        case '\0':
+            return token_type::end_of_input;
+
+        default:
+            fail("unexpected character", static_cast<uint32_t>(*ptr));
+            return token_type::uninitialized;
+        }
+    }
+
+    static token_type scan_literal(const source_char_type*& ptr, const source_char_type* last, const char* text,
+                                   token_type result)
+    {
+        for (const char* ch = text; *ch; ++ch, ++ptr)
+        {
+            if (ptr == last || *ptr != source_char_type(*ch))
+            {
+                detail::fast_ostringstream ss;
+                ss << "unexpected character (expected literal '" << text << "')";
+                throw configor_deserialization_error(ss.str());
+            }
+        }
+        return result;
+    }
+
+    // the number is only validated by the parser
+    static token_type scan_number(const source_char_type*& ptr, const source_char_type* last)
+    {
+        token_type result = token_type::value_integer;
+        bool       digits = false;
+        for (; ptr != last; ++ptr)
+        {
+            const auto ch = *ptr;
+            if (ch >= '0' && ch <= '9')
+                digits = true;
+            else if (ch == '.' || ch == 'e' || ch == 'E')
+                result = token_type::value_float;
+            else if (ch != '-' && ch != '+')
+                break;
+        }
+
+        if (!digits)
+            fail("unexpected number without digits");
+        return result;
+    }
+
+    // skips the value at `ptr` without validating arrays and objects
+    static const source_char_type* skip_value(const source_char_type* ptr, const source_char_type* last)
+    {
+        const token_type token = scan(ptr, last);
+        switch (token)
+        {
+        case token_type::begin_array:
+        case token_type::begin_object:
+            return skip_nested(ptr, last);
+        case token_type::value_string:
+        case token_type::value_integer:
+        case token_type::value_float:
+        case token_type::literal_true:
+        case token_type::literal_false:
+        case token_type::literal_null:
+            return ptr;
+        default:
+            fail(token);
+            return ptr;
+        }
+    }
+
+    // skips the rest of an array or object by matching brackets
+    static const source_char_type* skip_nested(const source_char_type* ptr, const source_char_type* last)
+    {
+        std::size_t depth = 1;
+        while (true)
+        {
+            ptr = detail::simd::find_nesting_char(ptr, last);
+            if (ptr == last)
+                fail("unexpected eof");
+
+            switch (*ptr)
+            {
+            case '\"':
+                ptr = skip_string(ptr, last);
+                break;
+            case '/':
+                if (!parser_type::traits_type::comments)
+                    fail("unexpected character", static_cast<uint32_t>(*ptr));
+                ptr = skip_comment(ptr, last);
+                break;
+            case '[':
+            case '{':
+                ++depth;
+                ++ptr;
+                break;
+            default:
+                ++ptr;
+                if (--depth == 0)
+                    return ptr;
+                break;
+            }
+        }
+    }
+
+    static const source_char_type* skip_string(const source_char_type* ptr, const source_char_type* last)
+    {
+        ++ptr;
+        while (true)
+        {
+            ptr = detail::simd::find_first_of(ptr, last, source_char_type('\"'), source_char_type('\\'));
+            if (ptr == last)
+                fail("unexpected end of string");
+
+            if (*ptr == source_char_type('\"'))
+                return ptr + 1;
+
+            // skip the escaped character
+            if (last - ptr < 2)
+                fail("unexpected end of string");
+            ptr += 2;
+        }
+    }
+
+    static const source_char_type* skip_spaces(const source_char_type* ptr, const source_char_type* last)
+    {
+        while (true)
+        {
+            ptr = detail::simd::skip_whitespace(ptr, last);
+            if (!parser_type::traits_type::comments || ptr == last || *ptr != source_char_type('/'))
+                return ptr;
+            ptr = skip_comment(ptr, last);
+        }
+    }
+
+    static const source_char_type* skip_comment(const source_char_type* ptr, const source_char_type* last)
+    {
+        ++ptr;
+        if (ptr != last && *ptr == source_char_type('/'))
+        {
+            return detail::simd::find_first_of(ptr + 1, last, source_char_type('\n'), source_char_type('\r'));
+        }
+
+        if (ptr != last && *ptr == source_char_type('*'))
+        {
+            ++ptr;
+            while (true)
+            {
+                ptr = detail::simd::find(ptr, last, source_char_type('*'));
+                if (ptr == last)
+                    fail("unexpected eof while reading comment");
+
+                ++ptr;
+                if (ptr != last && *ptr == source_char_type('/'))
+                    return ptr + 1;
+            }
+        }
+
+        fail("unexpected character '/'");
+        return last;
+    }
+
+    static void fail(const std::string& msg)
+    {
+        throw configor_deserialization_error(msg);
+    }
+
+    static void fail(const std::string& msg, uint32_t ch)
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << ch << "'";
+        throw configor_deserialization_error(ss.str());
+    }
+
+    static void fail(token_type actual_token, const std::string& msg = "unexpected token")
+    {
+        detail::fast_ostringstream ss;
+        ss << msg << " '" << to_string(actual_token) << "'";
+        throw configor_deserialization_error(ss.str());
+    }
+
+    static void fail(token_type actual_token, token_type expected_token, const std::string& msg = "unexpected token")
+    {
+        fail(actual_token, msg + ", expect '" + to_string(expected_token) + "', but got");
+    }
+
+private:
+    const source_char_type* begin_;
+    const source_char_type* next_;
+    const source_char_type* last_;
+    token_type              token_;
+    options_type            options_;
+};
+
+//
+// json_field_reader
+// reads the tokens of a json_reader straight into the fields of a type bound by CONFIGOR_BIND
+// booleans, numbers, strings, vectors and bound types are read directly,
+// other fields are read through a value
+// the results and errors are the same as converting the parsed value
+//
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_field_reader
+{
+public:
+    using value_type   = _ValTy;
+    using reader_type  = json_reader<value_type, _SourceCharTy, _DefaultEncoding>;
+    using string_type  = typename value_type::string_type;
+    using boolean_type = typename value_type::boolean_type;
+
+    // errors are thrown like value::get<_Ty>()
+    template <typename _Ty>
+    static void read_document(reader_type& r, _Ty& v)
+    {
+        r.next();
+        get(r, v);
+
+        if (r.next() != token_type::end_of_input)
+            throw configor_deserialization_error("unexpected token after the document");
+    }
+
+    // the current token of the reader is the first token of a value,
+    // afterwards it is the last token of the value
+    // conversion errors are ignored like value::get(_Ty&), syntax errors are thrown
+    template <typename _Ty>
+    static void read(reader_type& r, _Ty& v)
+    {
+        const std::size_t depth = r.depth();
+        try
+        {
+            if (read_direct(r, v, priority<1>{}))
+                return;
+        }
+        catch (const configor_deserialization_error&)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            // a conversion error is thrown at the last token of a nested value, the rest is skipped
+            while (r.depth() > depth)
+                r.next();
+            return;
+        }
+
+        value_type c;
+        r.read_value(c);
+        c.get(v);
+    }
+
+private:
+    // like value::get<_Ty>(), conversion errors are thrown at the last token of the value
+    template <typename _Ty>
+    static void get(reader_type& r, _Ty& v)
+    {
+        if (!read_direct(r, v, priority<1>{}))
+        {
+            value_type c;
+            r.read_value(c);
+            v = c.template get<_Ty>();
+        }
+    }
+
+    // each read_direct returns false without reading anything if the value is read through a value,
+    // otherwise it converts like from_value and throws the same errors
+
+    template <typename _Ty, typename std::enable_if<has_field_table<value_type, _Ty>::value, int>::type = 0>
+    static bool read_direct(reader_type& r, _Ty& v, priority<1>)
+    {
+        if (r.token() != token_type::begin_object)
+            return false;
+
+        const auto& table = field_table<value_type, _Ty>::get(v);
+
+        field_collector fields;
+        configor_visit_fields(static_cast<const value_type*>(nullptr), v, fields);
+
+        std::uint64_t seen = 0;
+        while (r.next() != token_type::end_object)
+        {
+            const std::size_t i = table.find(r.get_string());
+            if (i == table.size() || (seen & (uint64_t(1) << i)))
+            {
+                // unknown key, or a duplicated key whose first value is kept
+                r.skip_value();
+                continue;
+            }
+
+            seen |= uint64_t(1) << i;
+            r.next();
+            fields.refs[i].read(r, fields.refs[i].ptr);
+        }
+
+        // like value::at() for a missing required field
+        if ((table.required() & seen) != table.required())
+            throw std::out_of_range("operator[] key out of range");
+        return true;
+    }
+
+    static bool read_direct(reader_type& r, value_type& v, priority<1>)
+    {
+        r.read_value(v);
+        return true;
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_same<_Ty, boolean_type>::value, int>::type = 0>
+    static bool read_direct(reader_type& r, _Ty& v, priority<1>)
+    {
+        if (r.token() != token_type::literal_true && r.token() != token_type::literal_false)
+            return false;
+        v = r.get_boolean();
+        return true;
+    }
+
+    // an integer out of the range of integer_type is a float token, which is read through a value and rejected,
+    // a narrower type is assigned like from_value
+    template <typename _Ty, typename std::enable_if<
+                                std::is_integral<_Ty>::value && !std::is_same<_Ty, boolean_type>::value, int>::type = 0>
+    static bool read_direct(reader_type& r, _Ty& v, priority<1>)
+    {
+        if (r.token() != token_type::value_integer)
+            return false;
+        v = static_cast<_Ty>(r.get_integer());
+        return true;
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_floating_point<_Ty>::value, int>::type = 0>
+    static bool read_direct(reader_type& r, _Ty& v, priority<1>)
+    {
+        if (r.token() != token_type::value_float)
+            return false;
+        v = static_cast<_Ty>(r.get_float());
+        return true;
+    }
+
+    template <typename _Ty, typename std::enable_if<std::is_same<_Ty, string_type>::value, int>::type = 0>
+    static bool read_direct(reader_type& r, _Ty& v, priority<1>)
+    {
+        if (r.token() != token_type::value_string)
+            return false;
+        v = r.get_string();
+        return true;
+    }
+
+    // like from_value, the vector is resized to the array and the elements before a failed one are assigned
+    template <typename _Ty>
+    static bool read_direct(reader_type& r, std::vector<_Ty>& v, priority<1>)
+    {
+        if (r.token() != token_type::begin_array)
+            return false;
+
+        // read into a local element, since std::vector<bool> has no addressable elements
+        std::size_t size = 0;
+        try
+        {
+            while (r.next() != token_type::end_array)
+            {
+                _Ty element{};
+                get(r, element);
+                if (size < v.size())
+                    v[size] = std::move(element);
+                else
+                    v.push_back(std::move(element));
+                ++size;
+            }
+        }
+        catch (const configor_deserialization_error&)
+        {
+            throw;
+        }
+        catch (...)
+        {
+            ++size;
+            while (r.next() != token_type::end_array)
+            {
+                r.skip_value();
+                ++size;
+            }
+            v.resize(size);
+            throw;
+        }
+        v.resize(size);
+        return true;
+    }
+
+    template <typename _Ty>
+    static bool read_direct(reader_type&, _Ty&, priority<0>)
+    {
+        return false;
+    }
+
+    // the fields of the object being read, visited once per object
+    struct field_ref
+    {
+        void* ptr;
+        void (*read)(reader_type&, void*);
+    };
+
+    struct field_collector
+    {
+        field_ref   refs[max_bound_fields];
+        std::size_t size = 0;
+
+        template <typename _CharTy, typename _FieldTy>
+        void operator()(const _CharTy*, _FieldTy& field, bool)
+        {
+            field_ref& ref = refs[size++];
+            ref.ptr        = std::addressof(field);
+            ref.read       = &read_field<_FieldTy>;
+        }
+    };
+
+    template <typename _FieldTy>
+    static void read_field(reader_type& r, void* field)
+    {
+        read(r, *static_cast<_FieldTy*>(field));
+    }
+};
+
+//
+// json_selector
+// reads the values at a set of json pointers (RFC 6901) with a json_reader, the other values are skipped
+// a selected element of an array keeps its index, the elements before it are null
+//
+
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_selector
+{
+public:
+    using value_type  = _ValTy;
+    using reader_type = json_reader<value_type, _SourceCharTy, _DefaultEncoding>;
+    using string_type = typename value_type::string_type;
+    using char_type   = typename value_type::char_type;
+
+    explicit json_selector(const std::vector<string_type>& pointers)
+        : root_()
+    {
+        for (const auto& pointer : pointers)
+            add(pointer);
+    }
+
+    // reads the document of the reader
+    value_type select(reader_type& r) const
+    {
+        value_type result;
+        r.next();
+        select(r, root_, result);
+
+        if (r.next() != token_type::end_of_input)
+            throw configor_deserialization_error("unexpected token after the document");
+        return result;
+    }
+
+private:
+    // children are held by pointer, since std::map of an incomplete type is not allowed before C++17
+    struct node
+    {
+        bool                                         selected = false;
+        std::map<string_type, std::unique_ptr<node>> children;
+    };
+
+    void add(const string_type& pointer)
+    {
+        if (!pointer.empty() && pointer[0] != '/')
+            throw configor_invalid_key("json pointer must be empty or begin with '/'");
+
+        node* current = &root_;
+        for (std::size_t pos = 0; pos < pointer.size() && !current->selected;)
+        {
+            string_type token;
+            for (++pos; pos < pointer.size() && pointer[pos] != '/'; ++pos)
+            {
+                if (pointer[pos] != '~')
+                {
+                    token.push_back(pointer[pos]);
+                    continue;
+                }
+
+                // escaped '~' or '/'
+                const char_type next = (pos + 1 < pointer.size()) ? pointer[++pos] : char_type(0);
+                if (next != '0' && next != '1')
+                    throw configor_invalid_key("invalid escape in json pointer");
+                token.push_back(next == '0' ? char_type('~') : char_type('/'));
+            }
+            std::unique_ptr<node>& child = current->children[token];
+            if (!child)
+                child.reset(new node);
+            current = child.get();
+        }
+
+        // a selected value includes all of its children
+        current->selected = true;
+        current->children.clear();
+    }
+
+    // the current token of the reader is the first token of a value,
+    // afterwards it is the last token of the value
+    // returns false if nothing is selected inside the value
+    bool select(reader_type& r, const node& n, value_type& out) const
+    {
+        if (n.selected)
+        {
+            r.read_value(out);
+            return true;
+        }
+
+        bool found = false;
+        switch (r.token())
+        {
+        case token_type::begin_object:
+        {
+            // the first value of a duplicated key is kept like parse, even if nothing is selected inside it
+            std::set<const node*> visited;
+            while (r.next() != token_type::end_object)
+            {
+                const auto iter = n.children.find(r.get_string());
+                if (iter == n.children.end() || !visited.insert(iter->second.get()).second)
+                {
+                    r.skip_value();
+                    continue;
+                }
+
+                string_type key = r.get_string();
+                value_type  child;
+                r.next();
+                if (select(r, *iter->second, child))
+                {
+                    if (!found)
+                        out = value_constant::object;
+                    out[key] = std::move(child);
+                    found    = true;
+                }
+            }
+            break;
+        }
+
+        case token_type::begin_array:
+            for (std::size_t i = 0; r.next() != token_type::end_array; ++i)
+            {
+                const auto iter = n.children.find(index_key(i));
+                if (iter == n.children.end())
+                {
+                    r.skip_value();
+                    continue;
+                }
+
+                value_type child;
+                if (select(r, *iter->second, child))
+                {
+                    if (!found)
+                        out = value_constant::array;
+                    out[i] = std::move(child);
+                    found  = true;
+                }
+            }
+            break;
 
-    inline void fail(const std::string& msg)
-    {
-        throw configor_deserialization_error(msg);
+        default:
+            break;
+        }
+        return found;
     }
 
-    template <typename _IntTy>
-    inline void fail(const std::string& msg, _IntTy code)
+    static string_type index_key(std::size_t i)
     {
-        detail::fast_ostringstream ss;
-        ss << msg << " '" << make_json_hex(code) << "'";
-        fail(ss.str());
+        string_type key;
+        do
+        {
+            key.insert(key.begin(), char_type('0' + i % 10));
+            i /= 10;
+        } while (i != 0);
+        return key;
     }
 
 private:
-    bool                              is_negative_;
-    uint32_t                          current_;
-    typename value_type::integer_type number_integer_;
-    typename value_type::float_type   number_float_;
+    node root_;
 };
 
 //
 // json_serializer
 //
 
-template <typename _ValTy, typename _TargetCharTy>
-class json_serializer : public basic_serializer<_ValTy, _TargetCharTy>
+template <typename _ValTy, typename _TargetCharTy, typename _TraitsTy>
+class json_serializer
+    : public basic_serializer<_ValTy, _TargetCharTy, json_serializer<_ValTy, _TargetCharTy, _TraitsTy>>
 {
 public:
     using value_type       = _ValTy;
     using source_char_type = typename value_type::char_type;
     using target_char_type = _TargetCharTy;
+    using traits_type      = _TraitsTy;
+
+    // the serializer with the traits changed by options given as types
+    template <typename _OptionsTy>
+    using rebind_options =
+        json_serializer<value_type, target_char_type, typename _OptionsTy::template serializer_traits<traits_type>>;
 
     using option = std::function<void(json_serializer&)>;
 
     static option with_indent(uint8_t indent_step, target_char_type indent_char = ' ')
     {
-        return [=](json_serializer& s)
-        {
-            s.indent_       = indent<target_char_type>{ indent_step, indent_char };
-            s.pretty_print_ = indent_step > 0;
-        };
+        return [=](json_serializer& s) { s.set_indent(indent_step, indent_char); };
     }
 
     static option with_unicode_escaping(bool enabled)
     {
-        return [=](json_serializer& s) { s.unicode_escaping_ = enabled; };
+        return [=](json_serializer& s) { s.set_unicode_escaping(enabled); };
     }
 
+    // floats are written with the precision instead of the shortest representation
     static option with_precision(int precision, std::ios_base::fmtflags floatflags = std::ios_base::fixed)
     {
-        return [=](json_serializer& s)
-        {
-            s.os_.precision(static_cast<std::streamsize>(precision));
-            s.os_.setf(floatflags, std::ios_base::floatfield);
-        };
+        return [=](json_serializer& s) { s.set_precision(precision, floatflags); };
+    }
+
+    // floats are written with the shortest representation which reads back to the same value,
+    // or with the precision and float flags of the stream if disabled
+    static option with_shortest_float(bool enabled)
+    {
+        return [=](json_serializer& s) { s.set_shortest_float(enabled); };
     }
 
     static option with_error_handler(error_handler* eh)
@@ -714,10 +3526,11 @@ public:
     }
 
     explicit json_serializer(std::basic_ostream<target_char_type>& os)
-        : basic_serializer<value_type, target_char_type>(os)
+        : basic_serializer<value_type, target_char_type, json_serializer>(os)
         , pretty_print_(os.width() > 0)
         , object_or_array_began_(false)
         , unicode_escaping_(false)
+        , shortest_float_(!has_float_format(os))
         , last_token_(token_type::uninitialized)
         , indent_(static_cast<uint8_t>(os.width()), os.fill())
     {
@@ -725,6 +3538,58 @@ public:
         os.width(0);  // clear width
     }
 
+    inline void set_indent(uint8_t indent_step, target_char_type indent_char = ' ')
+    {
+        indent_       = indent<target_char_type>{ indent_step, indent_char };
+        pretty_print_ = indent_step > 0;
+    }
+
+    inline void set_unicode_escaping(bool enabled)
+    {
+        unicode_escaping_ = enabled;
+    }
+
+    // turns off the shortest representation
+    inline void set_precision(int precision, std::ios_base::fmtflags floatflags = std::ios_base::fixed)
+    {
+        shortest_float_ = false;
+        this->os_.precision(static_cast<std::streamsize>(precision));
+        this->os_.setf(floatflags, std::ios_base::floatfield);
+    }
+
+    // on by default, unless the stream passed to the constructor has float flags or a precision other than 6
+    // a precision of 6 set on the stream cannot be told apart from the default, so it is only used
+    // if the shortest representation is turned off or the precision is given with set_precision()
+    inline void set_shortest_float(bool enabled)
+    {
+        shortest_float_ = enabled;
+    }
+
+    // an encoding of the traits is kept
+    template <template <class> class _Encoding>
+    inline void set_source_encoding()
+    {
+        basic_serializer<value_type, target_char_type, json_serializer>::template set_source_encoding<
+            traits_encoding<_Encoding>::template source>();
+    }
+
+    template <template <class> class _Encoding>
+    inline void set_target_encoding()
+    {
+        basic_serializer<value_type, target_char_type, json_serializer>::template set_target_encoding<
+            traits_encoding<_Encoding>::template target>();
+    }
+
+    // writes to another buffer with the same settings
+    void reset(std::basic_streambuf<target_char_type>* buf)
+    {
+        basic_serializer<value_type, target_char_type, json_serializer>::reset(buf);
+
+        object_or_array_began_ = false;
+        last_token_            = token_type::uninitialized;
+        indent_.reset();
+    }
+
     inline void prepare(std::initializer_list<option> options)
     {
         std::for_each(options.begin(), options.end(), [&](const option& option) { option(*this); });
@@ -735,9 +3600,9 @@ public:
         }
     }
 
-    virtual void next(token_type token) override
+    void next(token_type token)
     {
-        if (object_or_array_began_)
+        if (traits_type::pretty && object_or_array_began_)
         {
             object_or_array_began_ = false;
             switch (token)
@@ -762,7 +3627,7 @@ public:
             }
         }
 
-        if (pretty_print_ && last_token_ != token_type::name_separator)
+        if (is_pretty() && last_token_ != token_type::name_separator)
         {
             switch (token)
             {
@@ -855,14 +3720,31 @@ public:
         last_token_ = token;
     }
 
-    virtual void put_integer(typename value_type::integer_type i) override
+    // the stream has a precision or float flags other than the default
+    static bool has_float_format(const std::basic_ostream<target_char_type>& os)
+    {
+        return (os.flags() & std::ios_base::floatfield) != 0 || os.precision() != 6;
+    }
+
+    void put_integer(typename value_type::integer_type i)
     {
-        this->os_ << i;
+        target_char_type  buffer[format::max_integer_length];
+        target_char_type* last  = buffer + format::max_integer_length;
+        target_char_type* first = format::write_integer_backward(last, i);
+        this->os_.write(first, static_cast<std::streamsize>(last - first));
     }
 
-    virtual void put_float(typename value_type::float_type f) override
+    void put_float(typename value_type::float_type f)
     {
-        if (std::ceil(f) == std::floor(f))
+        using float_type = typename value_type::float_type;
+
+        if (shortest_float_ && std::isfinite(f))
+        {
+            if (put_shortest_float(f, floating::has_binary_format<float_type>{}))
+                return;
+        }
+
+        if (std::ceil(f) == std::floor(f) && std::fabs(f) < static_cast<float_type>(int64_t(1) << 62))
         {
             // integer
             this->os_ << static_cast<int64_t>(f) << ".0";
@@ -873,93 +3755,191 @@ public:
         }
     }
 
-    virtual void put_string(const typename value_type::string_type& s) override
+    bool put_shortest_float(typename value_type::float_type f, std::true_type)
+    {
+        target_char_type buffer[format::max_float_length];
+        target_char_type* last = format::write_float(buffer, f);
+        this->os_.write(buffer, static_cast<std::streamsize>(last - buffer));
+        return true;
+    }
+
+    bool put_shortest_float(typename value_type::float_type, std::false_type)
+    {
+        // not an IEEE-754 single or double
+        return false;
+    }
+
+    // keys of printable ascii characters other than quotes and backslashes are written as they are with every option
+    static bool make_key_literal(const typename value_type::string_type& key,
+                                 std::basic_string<target_char_type>&    literal)
+    {
+        literal.push_back('\"');
+        for (const auto ch : key)
+        {
+            if (ch < 0x20 || ch > 0x7E || ch == '\"' || ch == '\\')
+                return false;
+            literal.push_back(static_cast<target_char_type>(ch));
+        }
+        literal.push_back('\"');
+        return true;
+    }
+
+    // the literals are written as they are, which put_string also does with a utf-8 target
+    bool writes_key_literals() const
+    {
+        return is_target_utf8();
+    }
+
+    void put_string(const typename value_type::string_type& s)
     {
         output('\"');
+        if (can_copy_utf8::value && !unicode_escaping_ && is_source_utf8() && is_target_utf8())
+            put_utf8_string(s.data(), s.data() + s.size(), can_copy_utf8{});
+        else
+            put_decoded_string(s.data(), s.data() + s.size());
+        output('\"');
+    }
 
-        fast_string_istreambuf<source_char_type> buf{ s };
-        std::basic_istream<source_char_type>     iss{ &buf };
+    void put_decoded_string(const source_char_type* first, const source_char_type* last)
+    {
+        fast_range_istreambuf<source_char_type> buf{ first, last };
+        std::basic_istream<source_char_type>    iss{ &buf };
 
         uint32_t codepoint = 0;
-        while (this->source_decoder_(iss, codepoint))
+        while (decode(iss, codepoint))
         {
             if (!iss.good())
             {
                 fail("unexpected character", codepoint);
             }
+            put_codepoint(codepoint);
+        }
+    }
 
-            switch (codepoint)
-            {
-            case '\t':
-            {
-                output({ '\\', 't' });
-                break;
-            }
-            case '\r':
-            {
-                output({ '\\', 'r' });
-                break;
-            }
-            case '\n':
-            {
-                output({ '\\', 'n' });
-                break;
-            }
-            case '\b':
-            {
-                output({ '\\', 'b' });
-                break;
-            }
-            case '\f':
-            {
-                output({ '\\', 'f' });
-                break;
-            }
-            case '\"':
-            {
-                output({ '\\', '\"' });
-                break;
-            }
-            case '\\':
+    void put_codepoint(uint32_t codepoint)
+    {
+        switch (codepoint)
+        {
+        case '\t':
+        {
+            output({ '\\', 't' });
+            break;
+        }
+        case '\r':
+        {
+            output({ '\\', 'r' });
+            break;
+        }
+        case '\n':
+        {
+            output({ '\\', 'n' });
+            break;
+        }
+        case '\b':
+        {
+            output({ '\\', 'b' });
+            break;
+        }
+        case '\f':
+        {
+            output({ '\\', 'f' });
+            break;
+        }
+        case '\"':
+        {
+            output({ '\\', '\"' });
+            break;
+        }
+        case '\\':
+        {
+            output({ '\\', '\\' });
+            break;
+        }
+        default:
+        {
+            // escape control characters
+            // and non-ASCII characters (if `escape_unicode` is true)
+            const bool need_escape = (codepoint <= 0x1F || (unicode_escaping_ && codepoint >= 0x7F));
+            if (!need_escape)
             {
-                output({ '\\', '\\' });
-                break;
+                // ASCII or BMP (U+0000...U+007F)
+                encode(codepoint);
             }
-            default:
+            else
             {
-                // escape control characters
-                // and non-ASCII characters (if `escape_unicode` is true)
-                const bool need_escape = (codepoint <= 0x1F || (unicode_escaping_ && codepoint >= 0x7F));
-                if (!need_escape)
+                if (codepoint <= 0xFFFF)
                 {
-                    // ASCII or BMP (U+0000...U+007F)
-                    this->target_encoder_(this->os_, codepoint);
+                    // BMP: U+007F...U+FFFF
+                    output_hex(codepoint);
                 }
                 else
                 {
-                    if (codepoint <= 0xFFFF)
-                    {
-                        // BMP: U+007F...U+FFFF
-                        this->os_ << make_json_hex(static_cast<uint16_t>(codepoint));
-                    }
-                    else
-                    {
-                        // supplementary planes: U+10000...U+10FFFF
-                        uint32_t lead_surrogate = 0, trail_surrogate = 0;
-                        encoding::unicode::encode_surrogates(codepoint, lead_surrogate, trail_surrogate);
-                        this->os_ << make_json_hex(lead_surrogate) << make_json_hex(trail_surrogate);
-                    }
+                    // supplementary planes: U+10000...U+10FFFF
+                    uint32_t lead_surrogate = 0, trail_surrogate = 0;
+                    encoding::unicode::encode_surrogates(codepoint, lead_surrogate, trail_surrogate);
+                    output_hex(lead_surrogate);
+                    output_hex(trail_surrogate);
                 }
+            }
 
-                if (!this->os_.good())
-                {
-                    fail("encoding failed with codepoint", codepoint);
-                }
-                break;
+            if (!this->os_.good())
+            {
+                fail("encoding failed with codepoint", codepoint);
             }
+            break;
+        }
+        }
+    }
+
+    using can_copy_utf8 = std::integral_constant<bool, sizeof(source_char_type) == 1
+                                                           && std::is_same<source_char_type, target_char_type>::value>;
+
+    // when both encodings are UTF-8, the runs of characters which need no escape are found with SIMD and copied at once
+    // a sequence is copied only if it is the canonical UTF-8 of its codepoint, otherwise it is encoded again
+    void put_utf8_string(const source_char_type* first, const source_char_type* last, std::true_type)
+    {
+        const source_char_type* run = first;
+        while (first != last)
+        {
+            first = simd::skip_plain_string(first, last);
+            if (first == last)
+                break;
+
+            const source_char_type* sequence = first;
+
+            uint32_t codepoint = 0;
+            if (!encoding::utf8<source_char_type>::decode(first, last, codepoint))
+            {
+                fail("unexpected character", codepoint);
             }
+
+            if (codepoint >= 0x80 && is_canonical_utf8(sequence, first, codepoint))
+                continue;
+
+            this->os_.write(run, static_cast<std::streamsize>(sequence - run));
+            put_codepoint(codepoint);
+            run = first;
         }
-        output('\"');
+        this->os_.write(run, static_cast<std::streamsize>(last - run));
+    }
+
+    void put_utf8_string(const source_char_type* first, const source_char_type* last, std::false_type)
+    {
+        put_decoded_string(first, last);
+    }
+
+    static bool is_canonical_utf8(const source_char_type* first, const source_char_type* last, uint32_t codepoint)
+    {
+        const std::ptrdiff_t length = codepoint <= 0x7FF ? 2 : (codepoint <= 0xFFFF ? 3 : 4);
+        if (last - first != length)
+            return false;
+
+        for (++first; first != last; ++first)
+        {
+            if ((static_cast<uint8_t>(*first) & 0xC0) != 0x80)
+                return false;
+        }
+        return true;
     }
 
     void output(target_char_type ch)
@@ -972,24 +3952,100 @@ public:
         this->os_.write(list.begin(), static_cast<std::streamsize>(list.size()));
     }
 
+    // writes \uXXXX
+    void output_hex(uint32_t code_unit)
+    {
+        target_char_type buffer[format::json_hex_length];
+        format::write_json_hex(buffer, code_unit);
+        this->os_.write(buffer, format::json_hex_length);
+    }
+
     void output_indent()
     {
-        if (pretty_print_)
+        if (is_pretty())
             this->os_ << indent_;
     }
 
     void output_indent(int length)
     {
-        if (pretty_print_)
+        if (is_pretty())
             indent_.put(this->os_, length);
     }
 
     void output_newline()
     {
-        if (pretty_print_)
+        if (is_pretty())
             this->os_.put('\n');
     }
 
+    inline bool is_pretty() const
+    {
+        return traits_type::pretty && pretty_print_;
+    }
+
+    // the encodings of the traits replace the encodings set at runtime
+    template <template <class> class _Encoding>
+    struct traits_encoding
+    {
+        template <typename _CharTy>
+        using source = typename std::conditional<
+            std::is_void<typename traits_type::template source_encoding<_CharTy>>::value, _Encoding<_CharTy>,
+            typename traits_type::template source_encoding<_CharTy>>::type;
+
+        template <typename _CharTy>
+        using target = typename std::conditional<
+            std::is_void<typename traits_type::template target_encoding<_CharTy>>::value, _Encoding<_CharTy>,
+            typename traits_type::template target_encoding<_CharTy>>::type;
+    };
+
+    using source_encoding_type = typename traits_type::template source_encoding<source_char_type>;
+    using target_encoding_type = typename traits_type::template target_encoding<target_char_type>;
+
+    using static_source_encoding = std::integral_constant<bool, !std::is_void<source_encoding_type>::value>;
+    using static_target_encoding = std::integral_constant<bool, !std::is_void<target_encoding_type>::value>;
+
+    inline bool is_source_utf8() const
+    {
+        return static_source_encoding::value ? encoding::is_utf8_encoding<source_encoding_type>::value
+                                             : this->source_utf8_;
+    }
+
+    inline bool is_target_utf8() const
+    {
+        return static_target_encoding::value ? encoding::is_utf8_encoding<target_encoding_type>::value
+                                             : this->target_utf8_;
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint)
+    {
+        return decode(is, codepoint, static_source_encoding{});
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint, std::true_type)
+    {
+        return source_encoding_type::decode(is, codepoint);
+    }
+
+    inline bool decode(std::basic_istream<source_char_type>& is, uint32_t& codepoint, std::false_type)
+    {
+        return this->source_decoder_(is, codepoint);
+    }
+
+    inline void encode(uint32_t codepoint)
+    {
+        encode(codepoint, static_target_encoding{});
+    }
+
+    inline void encode(uint32_t codepoint, std::true_type)
+    {
+        target_encoding_type::encode(this->os_, codepoint);
+    }
+
+    inline void encode(uint32_t codepoint, std::false_type)
+    {
+        this->target_encoder_(this->os_, codepoint);
+    }
+
     inline void fail(const std::string& msg, uint32_t codepoint)
     {
         fast_ostringstream ss;
@@ -1001,10 +4057,121 @@ private:
     bool                     pretty_print_;
     bool                     object_or_array_began_;
     bool                     unicode_escaping_;
+    bool                     shortest_float_;
     token_type               last_token_;
     indent<target_char_type> indent_;
 };
 
+//
+// json_parser_context
+//
+
+// keeps a parser with its settings and scratch buffers across parses
+// not thread-safe, use one context per thread
+template <typename _ValTy, typename _SourceCharTy, template <class> class _DefaultEncoding>
+class json_parser_context
+{
+public:
+    using value_type       = _ValTy;
+    using source_char_type = _SourceCharTy;
+    using parser_type      = json_parser<value_type, source_char_type>;
+    using option           = typename parser_type::option;
+
+    // the options are applied once for all parses
+    explicit json_parser_context(std::initializer_list<option> options = {})
+        : parser_(nullptr, nullptr)
+    {
+        parser_.template set_source_encoding<_DefaultEncoding>();
+        parser_.template set_target_encoding<_DefaultEncoding>();
+        parser_.prepare(options);
+    }
+
+    void parse(value_type& c, const source_char_type* buffer, std::size_t size)
+    {
+        parser_.reset(buffer, buffer + size);
+        parser_.parse(c);
+    }
+
+    value_type parse(const source_char_type* buffer, std::size_t size)
+    {
+        value_type c;
+        parse(c, buffer, size);
+        return c;
+    }
+
+    value_type parse(const source_char_type* str)
+    {
+        return parse(str, std::char_traits<source_char_type>::length(str));
+    }
+
+    value_type parse(const std::basic_string<source_char_type>& str)
+    {
+        return parse(str.data(), str.size());
+    }
+
+private:
+    parser_type parser_;
+};
+
+//
+// json_writer_context
+//
+
+// keeps a serializer with its settings, output buffer and indent string across dumps
+// not thread-safe, use one context per thread
+template <typename _ValTy, typename _TargetCharTy, template <class> class _DefaultEncoding>
+class json_writer_context
+{
+public:
+    using value_type       = _ValTy;
+    using target_char_type = _TargetCharTy;
+    using serializer_type  = json_serializer<value_type, target_char_type>;
+    using option           = typename serializer_type::option;
+    using string_type      = std::basic_string<target_char_type>;
+
+    // the options are applied once for all dumps
+    explicit json_writer_context(std::initializer_list<option> options = {})
+        : result_()
+        , buf_(result_)
+        , os_(&buf_)
+        , serializer_(os_)
+    {
+        serializer_.template set_source_encoding<_DefaultEncoding>();
+        serializer_.template set_target_encoding<_DefaultEncoding>();
+        serializer_.prepare(options);
+    }
+
+    // the result is overwritten by the next dump
+    const string_type& dump(const value_type& v)
+    {
+        result_.clear();
+        serializer_.reset(&buf_);
+        serializer_.dump(v);
+        return result_;
+    }
+
+    // appends to the string
+    void dump(string_type& str, const value_type& v)
+    {
+        fast_string_ostreambuf<target_char_type> buf{ str };
+        serializer_.reset(&buf);
+        serializer_.dump(v);
+    }
+
+    // the format flags and locale of the stream are not used
+    void dump(std::basic_ostream<target_char_type>& os, const value_type& v)
+    {
+        serializer_.reset(os.rdbuf());
+        serializer_.dump(v);
+    }
+
+private:
+    string_type                              result_;
+    fast_string_ostreambuf<target_char_type> buf_;
+    std::basic_ostream<target_char_type>     os_;
+    serializer_type                          serializer_;
+};
+
 }  // namespace detail
 
 }  // namespace configor
@@ -0,0 +1,344 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <sstream>      // std::stringstream
+#include <stdexcept>    // std::out_of_range
+#include <string>       // std::string
+#include <type_traits>  // std::true_type, std::false_type
+#include <vector>       // std::vector
+
+namespace
+{
+struct Address
+{
+    std::string city;
+    int         zip = 0;
+
+    CONFIGOR_BIND(json::value, Address, REQUIRED(city), OPTIONAL(zip, "zip code"));
+};
+
+struct User
+{
+    int                  id     = 0;
+    std::string          name;
+    double               score  = 0;
+    bool                 active = false;
+    std::vector<int>     tags;
+    std::vector<Address> addresses;
+    json::value          extra;
+    std::vector<float>   ratios;
+
+    CONFIGOR_BIND(json::value, User, REQUIRED(id), REQUIRED(name), OPTIONAL(score), OPTIONAL(active), OPTIONAL(tags),
+                  REQUIRED(addresses), OPTIONAL(extra), OPTIONAL(ratios));
+};
+
+struct Escaped
+{
+    std::string quoted;
+    int         unicode = 0;
+
+    CONFIGOR_BIND(json::value, Escaped, REQUIRED(quoted, "\"quoted\"\t"), OPTIONAL(unicode, "中文"));
+};
+
+struct Flags
+{
+    std::vector<bool> flags;
+    int               n = 0;
+
+    CONFIGOR_BIND(json::value, Flags, REQUIRED(flags), REQUIRED(n));
+};
+
+bool operator==(const Address& lhs, const Address& rhs)
+{
+    return lhs.city == rhs.city && lhs.zip == rhs.zip;
+}
+
+bool operator==(const User& lhs, const User& rhs)
+{
+    return lhs.id == rhs.id && lhs.name == rhs.name && lhs.score == rhs.score && lhs.active == rhs.active
+           && lhs.tags == rhs.tags && lhs.addresses == rhs.addresses && lhs.extra == rhs.extra
+           && lhs.ratios == rhs.ratios;
+}
+
+// parse_into gives the same result or throws the same error as parse().get<_Ty>()
+// the object read by parse_into is partial after an error
+template <typename _Ty>
+void check_same_as_get(const std::string& input)
+{
+    INFO(input);
+
+    _Ty         direct;
+    std::string direct_error;
+    try
+    {
+        json::parse_into(direct, input);
+    }
+    catch (const std::exception& e)
+    {
+        direct_error = e.what();
+    }
+
+    _Ty         converted;
+    std::string converted_error;
+    try
+    {
+        converted = json::parse(input).get<_Ty>();
+    }
+    catch (const std::exception& e)
+    {
+        converted_error = e.what();
+    }
+
+    CHECK(direct_error == converted_error);
+    if (converted_error.empty())
+        CHECK(direct == converted);
+}
+
+struct Named
+{
+    virtual ~Named() = default;
+
+    std::string name;
+};
+
+// the fields of Named are at another offset in a subobject of Shelf
+struct Item : virtual Named
+{
+    int n = 0;
+
+    CONFIGOR_BIND(json::value, Item, REQUIRED(name), REQUIRED(n));
+};
+
+struct Labeled : virtual Named
+{
+    int label = 0;
+};
+
+struct Shelf
+    : Labeled
+    , Item
+{
+    std::string title;
+};
+
+// has no operator!=, so an optional Opaque field is not compared with its default value
+struct Opaque
+{
+    int n = 0;
+
+    friend void to_value(json::value& c, const Opaque& v)
+    {
+        c = v.n;
+    }
+};
+
+struct Holder
+{
+    int    id = 0;
+    Opaque opaque;
+
+    friend void to_value(json::value& c, const Holder& v)
+    {
+        c["id"]     = v.id;
+        c["opaque"] = v.opaque;
+    }
+
+    template <typename _VisitorTy>
+    friend void configor_visit_fields(const json::value*, Holder& v, _VisitorTy& visitor)
+    {
+        visitor("id", v.id, std::true_type{});
+        visitor("opaque", v.opaque, std::false_type{});
+    }
+};
+}  // namespace
+
+TEST_CASE("test_bind")
+{
+    const std::string input =
+        "{ \"id\": 7, \"unknown\": { \"a\": [1, \"]}\"] }, \"name\": \"\\u4e2d\\u6587\", \"score\": 9.5,"
+        " \"active\": true, \"tags\": [1, 2, 3],"
+        " \"addresses\": [{ \"city\": \"x\", \"zip code\": 100 }, { \"city\": \"y\" }],"
+        " \"extra\": { \"k\": [null] }, \"ratios\": null, \"id\": 8 }";
+
+    SECTION("test_parse_into")
+    {
+        User u;
+        json::parse_into(u, input);
+        CHECK(u.id == 7);
+        CHECK(u.name == "中文");
+        CHECK(u.score == 9.5);
+        CHECK(u.active);
+        CHECK(u.tags == std::vector<int>{ 1, 2, 3 });
+        CHECK(u.addresses.size() == 2);
+        CHECK(u.addresses[0].city == "x");
+        CHECK(u.addresses[0].zip == 100);
+        CHECK(u.addresses[1].city == "y");
+        CHECK(u.addresses[1].zip == 0);
+        CHECK(u.extra == json::parse("{\"k\": [null]}"));
+        CHECK(u.ratios.empty());
+    }
+
+    SECTION("test_same_as_value")
+    {
+        User direct;
+        json::parse_into(direct, input);
+
+        const User converted = json::parse(input);
+        CHECK(direct.id == converted.id);
+        CHECK(direct.name == converted.name);
+        CHECK(direct.tags == converted.tags);
+        CHECK(direct.addresses.size() == converted.addresses.size());
+        CHECK(direct.extra == converted.extra);
+    }
+
+    SECTION("test_wrap")
+    {
+        User              u;
+        std::stringstream ss(input);
+        ss >> json::wrap(u);
+        CHECK(u.id == 7);
+        CHECK(u.addresses[1].city == "y");
+
+        // optional fields missing from the input are reset
+        u.score = 5;
+        u.tags  = { 4 };
+        std::stringstream ss2("{ \"id\": 1, \"name\": \"n\", \"addresses\": [] }");
+        ss2 >> json::wrap(u);
+        CHECK(u.id == 1);
+        CHECK(u.score == 0);
+        CHECK(u.tags.empty());
+        CHECK(u.addresses.empty());
+
+        // the object is left unchanged if parsing fails halfway
+        std::stringstream ss3("{ \"id\": 2, \"name\": \"m\", \"score\": 3, \"addresses\": [ }");
+        CHECK_THROWS_AS(ss3 >> json::wrap(u), configor_deserialization_error);
+        CHECK(u.id == 1);
+        CHECK(u.name == "n");
+        CHECK(u.score == 0);
+    }
+
+    SECTION("test_vector_bool")
+    {
+        const std::string flags_input = "{\"flags\":[true,false],\"n\":3}";
+
+        Flags f;
+        json::parse_into(f, flags_input);
+        CHECK(f.flags == std::vector<bool>{ true, false });
+        CHECK(f.n == 3);
+
+        Flags             wrapped;
+        std::stringstream ss(flags_input);
+        ss >> json::wrap(wrapped);
+        CHECK(wrapped.flags == std::vector<bool>{ true, false });
+        CHECK(wrapped.n == 3);
+        CHECK(json::dump(wrapped) == flags_input);
+    }
+
+    SECTION("test_virtual_base")
+    {
+        Item item;
+        json::parse_into(item, "{ \"name\": \"a\", \"n\": 1 }");
+        CHECK(item.name == "a");
+        CHECK(item.n == 1);
+
+        Shelf shelf;
+        json::parse_into(static_cast<Item&>(shelf), "{ \"name\": \"b\", \"n\": 2 }");
+        CHECK(shelf.name == "b");
+        CHECK(shelf.n == 2);
+        CHECK(shelf.label == 0);
+        CHECK(shelf.title.empty());
+    }
+
+    SECTION("test_mismatched_fields")
+    {
+        // conversion errors of fields are ignored like converting from a value,
+        // a vector is resized to the array and only the elements before a failed one are assigned
+        const std::string mismatched =
+            "{ \"id\": \"1\", \"name\": \"n\", \"tags\": [1, \"2\", 3], \"addresses\": [{ \"zip code\": 1 }, 2] }";
+
+        User direct;
+        json::parse_into(direct, mismatched);
+        CHECK(direct.id == 0);
+        CHECK(direct.name == "n");
+        CHECK(direct.tags == std::vector<int>{ 1, 0, 0 });
+        CHECK(direct.addresses.size() == 2);
+        CHECK(direct.addresses[0].zip == 0);
+
+        check_same_as_get<User>(mismatched);
+    }
+
+    SECTION("test_same_as_get")
+    {
+        const std::string required = "\"id\": 1, \"name\": \"n\", \"addresses\": []";
+
+        // out of range
+        check_same_as_get<User>("{ \"id\": 99999999999999999999, \"name\": \"n\", \"addresses\": [] }");
+        check_same_as_get<User>("{ \"id\": 4294967297, \"name\": \"n\", \"addresses\": [] }");
+        check_same_as_get<User>("{ " + required + ", \"tags\": [1, -99999999999999999999, 3] }");
+        check_same_as_get<User>("{ " + required + ", \"score\": 1e400 }");
+
+        // wrong types
+        check_same_as_get<User>("{ \"id\": 1.5, \"name\": null, \"addresses\": {} }");
+        check_same_as_get<User>("{ " + required + ", \"score\": 1, \"active\": 0, \"extra\": 1 }");
+        check_same_as_get<User>("{ " + required + ", \"tags\": [1, 2.5, [3]], \"ratios\": [0.5, 1] }");
+        check_same_as_get<User>("{ " + required + ", \"tags\": { \"a\": 1 }, \"ratios\": \"r\" }");
+        check_same_as_get<User>("{ \"id\": 1, \"name\": \"n\", \"addresses\": [{ \"city\": 1 }, { \"zip code\": 2 },"
+                                " { \"city\": \"z\" }] }");
+        check_same_as_get<User>("{ \"id\": 1, \"name\": \"n\", \"addresses\": [{ \"city\": \"a\", \"zip code\": \"1\" },"
+                                " null] }");
+        check_same_as_get<Address>("{ \"zip code\": 1 }");
+        check_same_as_get<Address>("[]");
+        check_same_as_get<Address>("\"x\"");
+    }
+
+    SECTION("test_errors")
+    {
+        User u;
+        CHECK_THROWS_AS(json::parse_into(u, "{ \"id\": 1 }"), std::out_of_range);
+        CHECK_THROWS_AS(json::parse_into(u, "{ \"id\": 1, \"name\": \"\", \"addresses\": [{}] } 1"),
+                        configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse_into(u, "[1]"), configor_invalid_key);
+        CHECK_THROWS_AS(json::parse_into(u, "{ \"id\": 1, \"name\": \"\", \"addresses\": [] } 1"),
+                        configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse_into(u, "{ \"id\": 1, \"name\": }"), configor_deserialization_error);
+    }
+
+    SECTION("test_dump")
+    {
+        User u;
+        json::parse_into(u, input);
+
+        // the same output as dumping the converted value
+        CHECK(json::dump(u) == json::dump(json::value(u)));
+        CHECK(json::dump(u, { json::serializer::with_indent(2) })
+              == json::dump(json::value(u), { json::serializer::with_indent(2) }));
+
+        std::stringstream ss;
+        ss << json::wrap(u);
+        CHECK(ss.str() == json::dump(json::value(u)));
+
+        User empty;
+        CHECK(json::dump(empty) == json::dump(json::value(empty)));
+        CHECK(json::dump(Address{}) == "{\"city\":\"\"}");
+    }
+
+    SECTION("test_dump_incomparable_fields")
+    {
+        Holder h;
+        h.id       = 1;
+        h.opaque.n = 2;
+        CHECK(json::dump(h) == "{\"id\":1,\"opaque\":2}");
+        CHECK(json::dump(h) == json::dump(json::value(h)));
+    }
+
+    SECTION("test_dump_escaped_keys")
+    {
+        Escaped e;
+        e.quoted  = "\"";
+        e.unicode = 1;
+        CHECK(json::dump(e) == json::dump(json::value(e)));
+        CHECK(json::dump(e, { json::serializer::with_unicode_escaping(true) })
+              == "{\"\\\"quoted\\\"\\t\":\"\\\"\",\"\\u4E2D\\u6587\":1}");
+    }
+}
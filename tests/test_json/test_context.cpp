@@ -0,0 +1,84 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <sstream>
+#include <string>
+
+TEST_CASE("test_context")
+{
+    SECTION("test_parser_context")
+    {
+        json::parser_context ctx;
+
+        const std::string inputs[] = {
+            "{\"id\": 42, \"name\": \"中文\", \"tags\": [\"a\", \"b\"]}",
+            "[1.5, -2, 12345678901234567890, null]",
+            "\"\\u4e2d\\t\"",
+            "true",
+        };
+        for (const auto& input : inputs)
+        {
+            CHECK(ctx.parse(input) == json::parse(input));
+        }
+
+        // the context can be reused after an error
+        CHECK_THROWS_AS(ctx.parse("[1, 2"), configor_deserialization_error);
+        CHECK_THROWS_AS(ctx.parse("1.5e"), configor_deserialization_error);
+        CHECK(ctx.parse("[1, 2]") == json::array{ 1, 2 });
+
+        const char buffer[] = "[1, 2]garbage";
+        CHECK(ctx.parse(buffer, 6) == json::array{ 1, 2 });
+    }
+
+    SECTION("test_parser_context_options")
+    {
+        json::parser_context ctx{ json::parser::with_max_depth(2), json::parser::with_structural_index() };
+
+        CHECK(ctx.parse("[[1], {\"a\": 1}]") == json::parse("[[1], {\"a\": 1}]"));
+        CHECK_THROWS_AS(ctx.parse("[[[1]]]"), configor_deserialization_error);
+
+        // the owned structural index is rebuilt for each buffer
+        CHECK(ctx.parse("{\"a\": [true, \"x\"]}") == json::object{ { "a", json::array{ true, "x" } } });
+        CHECK(ctx.parse("  [ 1 , 2 ]  ") == json::array{ 1, 2 });
+    }
+
+    SECTION("test_writer_context")
+    {
+        json::value j = json::object{ { "id", 42 }, { "name", "中文" }, { "list", json::array{ 1, 2.5, nullptr } } };
+
+        json::writer_context ctx;
+        CHECK(ctx.dump(j) == json::dump(j));
+        CHECK(ctx.dump(json::array{}) == "[]");
+        CHECK(ctx.dump(j) == json::dump(j));
+
+        std::string str = "prefix ";
+        ctx.dump(str, j);
+        CHECK(str == "prefix " + json::dump(j));
+
+        std::stringstream ss;
+        ctx.dump(ss, j);
+        CHECK(ss.str() == json::dump(j));
+
+        // the context can be reused after an error
+        CHECK_THROWS_AS(ctx.dump(json::value("\xFF")), configor_serialization_error);
+        CHECK(ctx.dump(j) == json::dump(j));
+    }
+
+    SECTION("test_writer_context_options")
+    {
+        json::value j = json::array{ json::object{ { "num", 1 } }, true };
+
+        json::writer_context ctx{ json::serializer::with_indent(2), json::serializer::with_unicode_escaping(true) };
+        const auto           expect =
+            json::dump(j, { json::serializer::with_indent(2), json::serializer::with_unicode_escaping(true) });
+
+        CHECK(ctx.dump(j) == expect);
+        CHECK(ctx.dump(j) == expect);
+
+        // the indent depth is restored after an error
+        CHECK_THROWS_AS(ctx.dump(json::array{ json::array{ "\xFF" } }), configor_serialization_error);
+        CHECK(ctx.dump(j) == expect);
+        CHECK(ctx.dump(json::value("中")) == "\"\\u4E2D\"");
+    }
+}
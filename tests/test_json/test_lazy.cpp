@@ -0,0 +1,111 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("test_lazy")
+{
+    const std::string input =
+        "{ \"id\": 12, \"skip\": { \"a\": [1, \"]}\", { \"b\": \"\\\"}\" }] /* ] */ }, \"pi\": 3.5, \"ok\": true,"
+        " \"name\": \"\\u4e2d\\u6587\", \"items\": [\"x\", null, [1, 2], {\"k\": \"v\"},], \"id\": 13 }";
+
+    const auto doc = json::lazy_parse(input);
+
+    SECTION("test_access")
+    {
+        CHECK(doc.is_object());
+        CHECK(doc["id"].get<int>() == 12);
+        CHECK(doc["pi"].get<double>() == 3.5);
+        CHECK(doc["ok"].get<bool>());
+        CHECK(doc["name"].get<std::string>() == "中文");
+        CHECK(doc["skip"]["a"][1].get<std::string>() == "]}");
+        CHECK(doc["skip"]["a"][2]["b"].get<std::string>() == "\"}");
+
+        const auto items = doc.at("items");
+        CHECK(items.is_array());
+        CHECK(items.size() == 4);
+        CHECK(items[0].is_string());
+        CHECK(items[1].is_null());
+        CHECK(items[2].type() == value_constant::array);
+        CHECK(items[3]["k"].get<std::string>() == "v");
+        CHECK(doc.size() == 7);
+
+        CHECK(items[2].raw() == "[1, 2]");
+        CHECK(doc["skip"].raw() == "{ \"a\": [1, \"]}\", { \"b\": \"\\\"}\" }] /* ] */ }");
+    }
+
+    SECTION("test_materialize")
+    {
+        // results match the eager parser
+        const auto expect = json::parse(input);
+        CHECK(doc.materialize() == expect);
+        CHECK(doc["items"].get<json::value>() == expect["items"]);
+        CHECK(doc["skip"].materialize() == expect["skip"]);
+    }
+
+    SECTION("test_lazy_options")
+    {
+        const std::string nested = "{\"a\\u0062\": [[1]], // c\n \"n\": 9223372036854775808}";
+
+        const auto deflt = json::lazy_parse(nested);
+        CHECK(deflt["ab"].size() == 1);
+        CHECK(deflt["n"].type() == value_constant::floating);
+
+        // the options of lazy_parse are used by the values found in it
+        const auto limited = json::lazy_parse(nested, { json::parser::with_max_depth(2),
+                                                        json::parser::with_integer_promotion(false) });
+        CHECK(limited["ab"][0].materialize() == json::parse("[1]"));
+        CHECK_THROWS_AS(limited.materialize(), configor_deserialization_error);
+        CHECK_THROWS_AS(limited["n"].get<double>(), configor_deserialization_error);
+    }
+
+    SECTION("test_lazy_error")
+    {
+        CHECK_THROWS_AS(doc["missing"], std::out_of_range);
+        CHECK_THROWS_AS(doc["items"][4], std::out_of_range);
+        CHECK_THROWS_AS(doc["id"]["x"], configor_invalid_key);
+        CHECK_THROWS_AS(doc[0], configor_invalid_key);
+
+        // only the accessed part is checked
+        const auto broken = json::lazy_parse("{\"a\": 1, \"b\": [1, 2 3]}");
+        CHECK(broken["a"].get<int>() == 1);
+        CHECK_THROWS_AS(broken["b"].materialize(), configor_deserialization_error);
+        CHECK_THROWS_AS(broken.materialize(), configor_deserialization_error);
+    }
+
+    SECTION("test_lazy_trailing")
+    {
+        // the document is checked to end after the value like the eager parser
+        for (const char* bad : { "1 2", "[1] x", "{\"a\":1}}", "true false", "", " // c\n", "\"a\" :" })
+        {
+            CHECK_THROWS_AS(json::parse(bad), configor_deserialization_error);
+            CHECK_THROWS_AS(json::lazy_parse(bad), configor_deserialization_error);
+        }
+
+        for (const char* good : { "1 ", "[1] // c\n", "{\"a\": 1} /* c */", "\"a\"" })
+        {
+            CHECK(json::lazy_parse(good).materialize() == json::parse(good));
+        }
+
+        const std::string with_nul("true\0 x", 7);
+        CHECK(json::lazy_parse(with_nul).materialize() == json::parse(with_nul));
+    }
+
+    SECTION("test_lazy_no_comments")
+    {
+        const std::string commented = "{\"a\": /* c */ 1, \"b\": [2 /* c */]}";
+        CHECK(json::lazy_parse(commented)["a"].get<int>() == 1);
+
+        // comments are rejected while scanning as well if the traits turn them off
+        CHECK_THROWS_AS(json::parse<json::opts::no_comments>(commented), configor_deserialization_error);
+        CHECK_THROWS_AS(json::lazy_parse<json::opts::no_comments>(commented), configor_deserialization_error);
+
+        const auto doc =
+            json::lazy_parse<json::opts::no_comments, json::opts::max_depth<1>>("{\"a\": [1, [2]]}");
+        CHECK(doc["a"].size() == 2);
+        CHECK(doc["a"][1].materialize() == json::parse("[2]"));
+        CHECK_THROWS_AS(doc["a"].materialize(), configor_deserialization_error);
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("test_ndjson")
+{
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+    {
+        input += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\\n" + std::to_string(i) + "\"}\n";
+        if (i % 100 == 0)
+            input += "  \r\n";
+    }
+
+    SECTION("test_parse")
+    {
+        for (std::size_t threads : { 1, 4 })
+        {
+            json::ndjson::reader r(threads);
+            r.set_batch_size(100);
+
+            auto values = r.parse(input.data(), input.size());
+            REQUIRE(values.size() == 1000);
+            for (int i = 0; i < 1000; ++i)
+            {
+                CHECK(values[i]["id"].get<int>() == i);
+                CHECK(values[i]["name"].get<std::string>() == "item\n" + std::to_string(i));
+            }
+
+            int next = 0;
+            r.parse(input.data(), input.size(), [&](json::value& v) { CHECK(v["id"].get<int>() == next++); });
+            CHECK(next == 1000);
+
+            std::atomic<int> sum{ 0 };
+            r.set_ordered(false).parse(input.data(), input.size(),
+                                       [&](json::value& v) { sum += v["id"].get<int>(); });
+            CHECK(sum == 999 * 1000 / 2);
+        }
+
+        // a record without trailing line break
+        CHECK(json::ndjson::reader().parse("1\n[2]", 5).size() == 2);
+    }
+
+    SECTION("test_parse_error")
+    {
+        const std::string bad = input + "{\"id\": }\n" + input;
+
+        json::ndjson::reader r(4);
+        r.set_batch_size(100);
+
+        int count = 0;
+        CHECK_THROWS_AS(r.parse(bad.data(), bad.size(), [&](json::value&) { ++count; }),
+                        configor_deserialization_error);
+        CHECK(count == 1000);
+        CHECK_THROWS_AS(r.parse(bad.data(), bad.size()), configor_deserialization_error);
+    }
+
+    SECTION("test_parse_file")
+    {
+        const std::string path = "tests/data/test_parse_file.ndjson";
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            ofs << input;
+            for (int i = 0; i < 100; ++i)
+                ofs << "{\"name\": \"plain\"}\n";
+        }
+
+        auto values = json::ndjson::reader(4).parse_file(path);
+        REQUIRE(values.size() == 1100);
+        CHECK(values[999]["id"].get<int>() == 999);
+
+        // strings are copied out of the file even if in-situ strings are enabled
+        auto insitu = insitu_json::ndjson::reader(4).parse_file(path, { insitu_json::parser::with_insitu_strings(true) });
+        std::remove(path.c_str());
+        REQUIRE(insitu.size() == 1100);
+        for (int i = 1000; i < 1100; ++i)
+        {
+            const auto& name = insitu[i]["name"].get<const insitu_json::value::string_type&>();
+            CHECK_FALSE(name.is_view());
+            CHECK(name == "plain");
+        }
+    }
+
+    SECTION("test_dump")
+    {
+        std::vector<json::value> values;
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(json::object{ { "id", i } });
+
+        for (std::size_t threads : { 1, 4 })
+        {
+            json::ndjson::writer w(threads);
+            w.set_batch_size(64);
+
+            const auto output = w.dump(values);
+            CHECK(json::ndjson::reader(threads).parse(output.data(), output.size()) == values);
+
+            std::ostringstream oss;
+            w.dump(oss, values.begin() + 10, values.begin() + 12);
+            CHECK(oss.str() == "{\"id\":10}\n{\"id\":11}\n");
+        }
+    }
+}
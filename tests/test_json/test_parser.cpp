@@ -3,8 +3,80 @@
 #include "common.h"
 
 #include <array>
+#include <cstdio>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+class event_recorder : public json::sax_handler
+{
+public:
+    std::string events;
+    std::string stop_at;
+
+    virtual bool null() override
+    {
+        return record("null");
+    }
+
+    virtual bool boolean(bool b) override
+    {
+        return record(b ? "true" : "false");
+    }
+
+    virtual bool integer(integer_type i) override
+    {
+        return record("i" + std::to_string(i));
+    }
+
+    virtual bool floating(float_type f) override
+    {
+        return record("f" + std::to_string(static_cast<int>(f * 10)));
+    }
+
+    virtual bool string(string_type& s) override
+    {
+        return record("s" + s);
+    }
+
+    virtual bool start_object() override
+    {
+        return record("{");
+    }
+
+    virtual bool key(string_type& s) override
+    {
+        return record("k" + s);
+    }
+
+    virtual bool end_object() override
+    {
+        return record("}");
+    }
+
+    virtual bool start_array() override
+    {
+        return record("[");
+    }
+
+    virtual bool end_array() override
+    {
+        return record("]");
+    }
+
+private:
+    bool record(const std::string& event)
+    {
+        events += event + " ";
+        return event != stop_at;
+    }
+};
+}  // namespace
 
 TEST_CASE("test_parser")
 {
@@ -70,6 +142,286 @@ TEST_CASE("test_parser")
         CHECK(json::parse("-12.5e-2").get<double>() == Approx(-0.125));
     }
 
+    SECTION("test_parse_float_rounding")
+    {
+        // results are correctly rounded
+        CHECK(json::parse("0.1").get<double>() == 0.1);
+        CHECK(json::parse("0.3").get<double>() == 0.3);
+        CHECK(json::parse("3.141592653589793").get<double>() == 3.141592653589793);
+        CHECK(json::parse("1.7976931348623157e308").get<double>() == 1.7976931348623157e308);
+        CHECK(json::parse("2.2250738585072014e-308").get<double>() == 2.2250738585072014e-308);
+        CHECK(json::parse("4.9406564584124654e-324").get<double>() == 4.9406564584124654e-324);
+        CHECK(json::parse("0.000000000000000000000000000001").get<double>() == 1e-30);
+
+        // halfway cases
+        CHECK(json::parse("9007199254740993.0").get<double>() == 9007199254740992.0);
+        CHECK(json::parse("9007199254740993.000000000000000000001").get<double>() == 9007199254740994.0);
+        CHECK(json::parse("1.00000000000000011102230246251565404236316680908203125").get<double>() == 1.0);
+        CHECK(json::parse("1.00000000000000011102230246251565404236316680908203126").get<double>()
+              == 1.0000000000000002);
+
+        // overflow and underflow
+        CHECK(json::parse("1e400").get<double>() == std::numeric_limits<double>::infinity());
+        CHECK(json::parse("-1e400").get<double>() == -std::numeric_limits<double>::infinity());
+        CHECK(json::parse("1e-400").get<double>() == 0.0);
+        CHECK(json::parse("1e99999999999").get<double>() == std::numeric_limits<double>::infinity());
+
+        CHECK_THROWS_AS(json::parse("1e-"), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse("1e+x"), configor_deserialization_error);
+    }
+
+    SECTION("test_parse_integer_overflow")
+    {
+        CHECK(json::parse("1234567890123456789").get<int64_t>() == int64_t(1234567890123456789));
+        CHECK(json::parse("[1234567890123456,1]") == json::array{ int64_t(1234567890123456), 1 });
+        CHECK(json::parse("-9223372036854775808").get<int64_t>() == (std::numeric_limits<int64_t>::min)());
+        CHECK(json::parse("0.1234567890123456789").get<double>() == 0.1234567890123456789);
+
+        // promoted to float
+        CHECK(json::parse("9223372036854775808").is_floating());
+        CHECK(json::parse("9223372036854775808").get<double>() == 9223372036854775808.0);
+        CHECK(json::parse("-9223372036854775809").get<double>() == -9223372036854775809.0);
+        CHECK(json::parse("123456789012345678901234567890").get<double>() == 123456789012345678901234567890.0);
+
+        CHECK_THROWS_AS(json::parse("9223372036854775808", { json::parser::with_integer_promotion(false) }),
+                        configor_deserialization_error);
+        CHECK_NOTHROW(json::parse("9223372036854775807", { json::parser::with_integer_promotion(false) }));
+    }
+
+    SECTION("test_sax_parse")
+    {
+        const std::string input = "{\"a\": [1, 2.5, \"s\", true, null], \"b\": {}}";
+
+        event_recorder recorder;
+        CHECK(json::sax_parse(input, recorder));
+        CHECK(recorder.events == "{ ka [ i1 f25 ss true null ] kb { } } ");
+
+        // stop parsing
+        event_recorder stopper;
+        stopper.stop_at = "ss";
+        CHECK_FALSE(json::sax_parse(input, stopper));
+        CHECK(stopper.events == "{ ka [ i1 f25 ss ");
+
+        // stream and buffer
+        std::istringstream iss(input);
+        event_recorder     stream_recorder;
+        CHECK(json::sax_parse(iss, stream_recorder));
+        CHECK(stream_recorder.events == recorder.events);
+
+        event_recorder buffer_recorder;
+        CHECK(json::sax_parse(input.data(), input.size(), buffer_recorder));
+        CHECK(buffer_recorder.events == recorder.events);
+
+        // errors
+        event_recorder error_recorder;
+        CHECK_THROWS_AS(json::sax_parse("[1, }", error_recorder), configor_deserialization_error);
+
+        // the first value of duplicated keys is kept
+        CHECK(json::parse("{\"a\": 1, \"a\": {\"a\": [2]}, \"b\": 3}") == json::object{ { "a", 1 }, { "b", 3 } });
+        CHECK(json::parse("{\"a\": {\"b\": 1, \"b\": [2, {}]}, \"c\": [3]}")
+              == json::object{ { "a", json::object{ { "b", 1 } } }, { "c", json::array{ 3 } } });
+
+        // sorted keys are appended, others are searched
+        CHECK(json::parse("{\"a\": 1, \"b\": 2, \"a\": 3, \"c\": 4, \"b\": 5, \"c\": 6}")
+              == json::object{ { "a", 1 }, { "b", 2 }, { "c", 4 } });
+        CHECK(json::parse("{\"c\": 1, \"a\": 2, \"d\": 3, \"b\": 4}")
+              == json::object{ { "a", 2 }, { "b", 4 }, { "c", 1 }, { "d", 3 } });
+    }
+
+    SECTION("test_max_depth")
+    {
+        CHECK_NOTHROW(json::parse("[[1], {\"a\": 1}]", { json::parser::with_max_depth(2) }));
+        CHECK_THROWS_AS(json::parse("[[[1]]]", { json::parser::with_max_depth(2) }), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse("{\"a\": {\"b\": {}}}", { json::parser::with_max_depth(2) }),
+                        configor_deserialization_error);
+
+        // deep nesting does not consume the call stack
+        const std::size_t depth = 100000;
+        const std::string deep  = std::string(depth, '[') + std::string(depth, ']');
+
+        event_recorder recorder;
+        CHECK(json::sax_parse(deep, recorder));
+        CHECK(recorder.events.size() == depth * 4);
+
+        // deeply nested values are built and destroyed without recursion, even without a max depth
+        {
+            const std::size_t deeper = 1000000;
+            json::value       j      = json::parse(std::string(deeper, '[') + std::string(deeper, ']'));
+            CHECK(j.is_array());
+            CHECK(j.size() == 1);
+        }
+
+        CHECK_THROWS_AS(json::parse(deep, { json::parser::with_max_depth(64) }), configor_deserialization_error);
+
+        json::reader r(deep, { json::parser::with_max_depth(64) });
+        for (int i = 0; i < 64; ++i)
+            CHECK(r.next() == token_type::begin_array);
+        CHECK_THROWS_AS(r.next(), configor_deserialization_error);
+    }
+
+    SECTION("test_parse_with_policies")
+    {
+        const std::string input = "{\"a\": [1, 2.5, \"中文\"], \"b\": 18446744073709551616}";
+        CHECK(json::parse<json::opts::utf8>(input) == json::parse(input));
+        CHECK(json::parse<json::opts::utf8>(input.c_str()) == json::parse(input));
+        CHECK(json::parse<json::opts::structural_index>(input.data(), input.size()) == json::parse(input));
+
+        std::istringstream iss(input);
+        CHECK(json::parse<json::opts::max_depth<2>, json::opts::utf8>(iss) == json::parse(input));
+
+        CHECK_THROWS_AS(json::parse<json::opts::max_depth<2>>("[[[1]]]"), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse<json::opts::integer_promotion<false>>(input), configor_deserialization_error);
+
+        // serializer options are ignored by the parser
+        CHECK(json::parse<json::opts::indent<4>>(input) == json::parse(input));
+
+        // comments are left out of the parser by no_comments
+        CHECK(json::parse<json::opts::utf8>("[1 /* c */, 2] // c") == json::parse("[1, 2]"));
+        CHECK_THROWS_AS(json::parse<json::opts::no_comments>("[1 /* c */, 2]"), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse<json::opts::no_comments>("[1, 2] // c"), configor_deserialization_error);
+
+        // encodings given as types are decoded without function pointers
+        const std::u16string wide = u"[\"中文\"]";
+        CHECK(json::parse<json::opts::source_encoding<encoding::utf16>, json::opts::target_encoding<encoding::utf8>>(
+                  wide)
+              == json::parse("[\"中文\"]"));
+
+        // character types are still accepted as the only template argument
+        CHECK(json::parse<char>(input) == json::parse(input));
+        CHECK(json::parse<char>(input.c_str()) == json::parse(input));
+        CHECK(json::parse<char>(input.data(), input.size()) == json::parse(input));
+    }
+
+    SECTION("test_parse_buffer")
+    {
+        const std::string input = "{ \"happy\": true, \"pi\": 3.141, \"name\": \"中文测试\" }";
+
+        std::istringstream iss(input);
+        CHECK(json::parse(input.data(), input.size()) == json::parse(iss));
+
+        // only the given range is parsed
+        const char buffer[] = "[1, 2]garbage";
+        CHECK(json::parse(buffer, 6) == json::array{ 1, 2 });
+        CHECK_THROWS_AS(json::parse(buffer, 5), configor_deserialization_error);
+
+        // truncated multi-byte sequence
+        CHECK_THROWS_AS(json::parse("\"\xE4\xB8"), configor_deserialization_error);
+    }
+
+    SECTION("test_parse_long_string")
+    {
+        const std::string plain(100, 'a');
+        CHECK(json::parse("\"" + plain + "\"") == plain);
+
+        // special characters in every position of a vector block
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            std::string expect = plain.substr(0, i) + "\"\\/\b\f\n\r\t" + plain.substr(i);
+            std::string input  = "\"" + plain.substr(0, i) + "\\\"\\\\\\/\\b\\f\\n\\r\\t" + plain.substr(i) + "\"";
+            CHECK(json::parse(input) == expect);
+
+            expect = plain.substr(0, i) + "中文测试" + plain.substr(i);
+            input  = "\"" + expect + "\"";
+            CHECK(json::parse(input) == expect);
+
+            input = "\"" + plain.substr(0, i) + "\x01" + plain.substr(i) + "\"";
+            CHECK_THROWS_AS(json::parse(input), configor_deserialization_error);
+
+            input = "\"" + plain.substr(0, i);
+            CHECK_THROWS_AS(json::parse(input), configor_deserialization_error);
+        }
+
+        const std::wstring wplain(100, L'a');
+        CHECK(wjson::parse("\"" + plain + "\\u4e2d\"") == wplain + L"\u4e2d");
+    }
+
+    SECTION("test_parse_insitu")
+    {
+        const std::string input = "{\"name\": \"中文测试\", \"escaped\": \"a\\tb\\u4e2d\", \"list\": [\"x\", \"\"]}";
+
+        auto j = insitu_json::parse(input.data(), input.size(), { insitu_json::parser::with_insitu_strings(true) });
+        REQUIRE(j.is_object());
+
+        // plain strings and keys refer to the input
+        const auto& name = j["name"].get<const insitu_json::value::string_type&>();
+        CHECK(name.is_view());
+        CHECK(name.data() > input.data());
+        CHECK(name.data() < input.data() + input.size());
+        CHECK(j["name"].get_string_view() == "中文测试");
+        CHECK(j.begin().key().is_view());
+        CHECK(j["list"][0].get<std::string>() == "x");
+        CHECK(j["list"][1].get_string_view().empty());
+
+        // escaped strings are copied
+        const auto& escaped = j["escaped"].get<const insitu_json::value::string_type&>();
+        CHECK_FALSE(escaped.is_view());
+        CHECK(escaped == "a\tb中");
+
+        // a copy still refers to the input, a modified string owns its characters
+        insitu_json::value copy = j;
+        CHECK(copy == j);
+        CHECK(copy["name"].get<const insitu_json::value::string_type&>().is_view());
+        copy["name"].get<insitu_json::value::string_type&>().push_back('!');
+        CHECK_FALSE(copy["name"].get<const insitu_json::value::string_type&>().is_view());
+        CHECK(copy["name"].get<std::string>() == "中文测试!");
+
+        CHECK(insitu_json::dump(j) == json::dump(json::parse(input)).c_str());
+
+        // strings are copied unless enabled
+        auto owned = insitu_json::parse(input.data(), input.size());
+        CHECK_FALSE(owned["name"].get<const insitu_json::value::string_type&>().is_view());
+        CHECK(owned == j);
+
+        CHECK(json::parse(input)["name"].get_string_view() == "中文测试");
+        CHECK_THROWS_AS(j["list"].get_string_view(), configor_type_error);
+    }
+
+    SECTION("test_parse_interned_keys")
+    {
+        const std::string input = "[{\"identifier\": 1, \"a long key name\": \"identifier\"},"
+                                  " {\"a long key name\": 2, \"identifier\": 3, \"\\u4e2d\": 4}]";
+
+        using parser = interned_json::parser;
+
+        intern_table table;
+        auto         j = interned_json::parse(input.data(), input.size(), { parser::with_key_interning(table) });
+        REQUIRE(j.size() == 2);
+        CHECK(table.size() == 3);
+
+        // equal keys share the same characters, other strings are not interned
+        const auto& first  = j[0].begin().key();
+        const auto& second = j[1].begin().key();
+        CHECK(first.is_shared());
+        CHECK(first == "a long key name");
+        CHECK(first.data() == second.data());
+        CHECK_FALSE(j[0]["a long key name"].get<const interned_json::value::string_type&>().is_shared());
+        CHECK(j[1]["中"].get<int>() == 4);
+
+        // a modified string owns its characters
+        interned_json::value copy = j;
+        CHECK(copy == j);
+        interned_json::value::string_type key = copy[0].begin().key();
+        key.push_back('!');
+        CHECK_FALSE(key.is_shared());
+        CHECK(key == "a long key name!");
+        CHECK(first == "a long key name");
+
+        CHECK(interned_json::dump(j) == json::dump(json::parse(input)).c_str());
+
+        // a table owned by the parser, or no interning
+        auto owned = interned_json::parse(input.data(), input.size(), { parser::with_key_interning() });
+        CHECK(owned[0].begin().key().is_shared());
+        CHECK(owned == j);
+        CHECK_FALSE(interned_json::parse(input.data(), input.size())[0].begin().key().is_shared());
+        CHECK(json::parse(input, { json::parser::with_key_interning() }) == json::parse(input));
+
+        // a full table stops interning
+        intern_table small(1);
+        auto         partial = interned_json::parse(input.data(), input.size(), { parser::with_key_interning(small) });
+        CHECK(small.size() == 1);
+        CHECK(partial == j);
+    }
+
     SECTION("test_parse_error")
     {
         // unexpected character
@@ -105,6 +457,11 @@ TEST_CASE("test_parser")
         CHECK_THROWS_AS(json::parse("1ex"), configor_deserialization_error);
         CHECK_THROWS_AS(json::parse("1e0"), configor_deserialization_error);
 
+        // sign without digits
+        CHECK_THROWS_AS(json::parse("-"), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse("-x"), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse("[-]"), configor_deserialization_error);
+
         // not allow comments
         {
             // TODO
@@ -159,6 +516,18 @@ TEST_CASE("test_parser")
 
         CHECK_THROWS_AS(json::parse("/* aaaa"), configor_deserialization_error);
         CHECK_THROWS_AS(json::parse("/* aaaa *"), configor_deserialization_error);
+
+        // long runs of whitespace and comments
+        const std::string spaces(100, ' ');
+        const std::string text(100, '*');
+        CHECK(json::parse(spaces + "[\r\n\t" + spaces + "1," + spaces + "\n\t\r 2\t" + spaces + "]" + spaces)
+              == json::array{ 1, 2 });
+        CHECK(json::parse("/*" + text + "*/ //" + text + "\r\n /*" + spaces + "*/1") == 1);
+        CHECK(json::parse("/***/1") == 1);
+        std::istringstream iss("/***/1");
+        CHECK(json::parse(iss) == 1);
+        CHECK(json::parse("1 // " + text) == 1);
+        CHECK_THROWS_AS(json::parse("/*" + text), configor_deserialization_error);
     }
 
     SECTION("test_parse_surrogate")
@@ -214,7 +583,29 @@ TEST_CASE("test_parser")
 
             // run tests
             tests[i](j);
+
+            // read the same file at once
+            json::value mapped;
+            CHECK_NOTHROW(mapped = json::parse_file(files[i]));
+            CHECK(mapped == j);
+
+            // and through a c-style file
+            std::FILE* file = std::fopen(files[i].c_str(), "r");
+            REQUIRE(file != nullptr);
+            CHECK(json::parse(file) == j);
+            std::fclose(file);
         }
+
+        event_recorder recorder;
+        CHECK(json::sax_parse_file(files[4], recorder));
+        CHECK_THROWS_AS(json::parse_file("tests/data/not_exist.json"), configor_deserialization_error);
+
+        // strings are copied out of the file even if in-situ strings are enabled
+        auto insitu = insitu_json::parse_file(files[0], { insitu_json::parser::with_insitu_strings(true) });
+        const auto& title = insitu["glossary"]["title"].get<const insitu_json::value::string_type&>();
+        CHECK_FALSE(title.is_view());
+        CHECK(title == "example glossary");
+        CHECK(insitu_json::dump(insitu) == json::dump(json::parse_file(files[0])).c_str());
     }
 
     SECTION("test_adapter")
@@ -274,3 +665,87 @@ TEST_CASE("test_parser")
         }
     }
 }
+
+namespace
+{
+// a parser implemented with the virtual functions of basic_parser, which reads prepared tokens
+class token_parser : public configor::detail::basic_parser<json::value, char>
+{
+public:
+    explicit token_parser(std::vector<token_type> tokens)
+        : basic_parser(nullptr, nullptr)
+        , tokens_(std::move(tokens))
+        , pos_(0)
+    {
+    }
+
+protected:
+    virtual token_type scan() override
+    {
+        return pos_ < tokens_.size() ? tokens_[pos_++] : token_type::end_of_input;
+    }
+
+    virtual void get_integer(json::value::integer_type& out) override
+    {
+        out = static_cast<json::value::integer_type>(pos_);
+    }
+
+    virtual void get_float(json::value::float_type& out) override
+    {
+        out = 0.5;
+    }
+
+    virtual void get_string(json::value::string_type& out) override
+    {
+        out = "s" + std::to_string(pos_);
+    }
+
+private:
+    std::vector<token_type> tokens_;
+    std::size_t             pos_;
+};
+
+// overrides the hook which parses every value
+class wrapping_parser : public token_parser
+{
+public:
+    using token_parser::token_parser;
+
+protected:
+    virtual void do_parse(json::value& c, token_type last_token, bool read_next) override
+    {
+        json::value v;
+        token_parser::do_parse(v, last_token, read_next);
+        c = json::object{ { "root", v } };
+    }
+};
+}  // namespace
+
+TEST_CASE("test_virtual_parser")
+{
+    token_parser p{ { token_type::begin_array, token_type::value_integer, token_type::value_separator,
+                      token_type::begin_object, token_type::value_string, token_type::name_separator,
+                      token_type::value_float, token_type::end_object, token_type::end_array } };
+
+    json::value j;
+    p.parse(j);
+    CHECK(j == json::array{ 2, json::object{ { "s5", 0.5 } } });
+
+    wrapping_parser wp{ { token_type::begin_array, token_type::literal_true, token_type::value_separator,
+                          token_type::begin_object, token_type::value_string, token_type::name_separator,
+                          token_type::literal_null, token_type::end_object, token_type::end_array } };
+    wp.parse(j);
+
+    // every element and member is wrapped too
+    const json::value member = json::object{ { "s5", json::object{ { "root", nullptr } } } };
+    CHECK(j == json::object{ { "root", json::array{ json::object{ { "root", true } },
+                                                    json::object{ { "root", member } } } } });
+
+    token_parser deep{ { token_type::begin_array, token_type::begin_array, token_type::end_array,
+                         token_type::end_array } };
+    deep.set_max_depth(1);
+    CHECK_THROWS_AS(deep.parse(j), configor_deserialization_error);
+
+    token_parser extra{ { token_type::literal_null, token_type::literal_null } };
+    CHECK_THROWS_AS(extra.parse(j), configor_deserialization_error);
+}
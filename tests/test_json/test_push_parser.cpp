@@ -0,0 +1,231 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <string>
+
+namespace
+{
+class key_collector : public json::sax_handler
+{
+public:
+    std::string keys;
+    std::string stop_at;
+
+    virtual bool null() override
+    {
+        return true;
+    }
+
+    virtual bool boolean(bool) override
+    {
+        return true;
+    }
+
+    virtual bool integer(integer_type) override
+    {
+        return true;
+    }
+
+    virtual bool floating(float_type) override
+    {
+        return true;
+    }
+
+    virtual bool string(string_type&) override
+    {
+        return true;
+    }
+
+    virtual bool start_object() override
+    {
+        return true;
+    }
+
+    virtual bool key(string_type& s) override
+    {
+        keys += s + " ";
+        return s != stop_at;
+    }
+
+    virtual bool end_object() override
+    {
+        return true;
+    }
+
+    virtual bool start_array() override
+    {
+        return true;
+    }
+
+    virtual bool end_array() override
+    {
+        return true;
+    }
+};
+}  // namespace
+
+TEST_CASE("test_push_parser")
+{
+    const std::string input =
+        "{ \"id\": 12, \"pi\": -3.5e1, \"name\": \"中文\\\"\\u6d4b\\u8bd5\\\\\", /* comment */ \"ok\": true,\n"
+        "  // line comment\n"
+        "  \"items\": [\"x\", null, false, [], {}, 12345678901234567890,], \"big\": 1e400 }";
+
+    SECTION("test_feed")
+    {
+        const json::value expect = json::parse(input);
+
+        for (std::size_t chunk : { 1, 2, 3, 7, 64, 1024 })
+        {
+            json::push_parser p;
+            for (std::size_t i = 0; i < input.size(); i += chunk)
+            {
+                CHECK_FALSE(p.done());
+                p.feed(input.data() + i, (std::min)(chunk, input.size() - i));
+            }
+            CHECK(p.done());
+            p.finish();
+            CHECK(p.value() == expect);
+        }
+    }
+
+    SECTION("test_finish")
+    {
+        // a number may continue in the next chunk
+        json::push_parser p;
+        CHECK_FALSE(p.feed("12"));
+        CHECK(p.feed("34 "));
+        p.finish();
+        CHECK(p.value() == 1234);
+
+        json::push_parser q;
+        CHECK_FALSE(q.feed("-0.5"));
+        q.finish();
+        CHECK(q.value() == -0.5);
+
+        json::push_parser incomplete;
+        incomplete.feed("[1, \"ab");
+        CHECK_THROWS_AS(incomplete.finish(), configor_deserialization_error);
+
+        json::push_parser empty;
+        CHECK_THROWS_AS(empty.finish(), configor_deserialization_error);
+    }
+
+    SECTION("test_error")
+    {
+        json::push_parser p;
+        CHECK_THROWS_AS(p.feed("[1, 2 3]"), configor_deserialization_error);
+
+        json::push_parser q;
+        CHECK(q.feed("{} "));
+        CHECK_THROWS_AS(q.feed("{}"), configor_deserialization_error);
+
+        json::push_parser r{ json::parser::with_max_depth(2) };
+        CHECK_THROWS_AS(r.feed("[[["), configor_deserialization_error);
+    }
+
+    SECTION("test_same_as_parse")
+    {
+        // a NUL character ends the input, and the bytes of a UTF-8 sequence are read whatever they are
+        const std::string inputs[] = {
+            std::string("\0 true", 6),     std::string("true\0 x", 7),     std::string("[1,\0 2]", 7),
+            std::string("[1]\xc0\x80 x", 7), std::string("\"a\xc3\"\"", 5), std::string("[\"\xe4\"1\"]", 7),
+            std::string("\"\\\xc3\"\"", 5), std::string("1\xe4\"1", 4),     std::string("\"\xe4\xb8\xad\"", 5),
+            std::string("[1\0]", 4),         std::string("[\"a\x01\"]", 6),   std::string("1\x01", 2),
+        };
+
+        for (const auto& str : inputs)
+        {
+            bool        accepted = true;
+            json::value expect;
+            try
+            {
+                expect = json::parse(str.data(), str.size());
+            }
+            catch (const configor_deserialization_error&)
+            {
+                accepted = false;
+            }
+
+            for (std::size_t chunk : { 1, 2, 64 })
+            {
+                json::push_parser p;
+                auto              feed_all = [&]()
+                {
+                    for (std::size_t i = 0; i < str.size(); i += chunk)
+                        p.feed(str.data() + i, (std::min)(chunk, str.size() - i));
+                    p.finish();
+                };
+
+                if (accepted)
+                {
+                    CHECK_NOTHROW(feed_all());
+                    CHECK(p.value() == expect);
+                }
+                else
+                {
+                    CHECK_THROWS_AS(feed_all(), configor_deserialization_error);
+                }
+            }
+        }
+    }
+
+    SECTION("test_control_characters")
+    {
+        // a NUL character ends the input once it is fed, like in the eager parser
+        json::push_parser p;
+        CHECK(p.feed(std::string("1\0x", 3)));
+        p.finish();
+        CHECK(p.value() == 1);
+
+        json::push_parser q;
+        CHECK_THROWS_AS(q.feed(std::string("[1\0", 3)), configor_deserialization_error);
+
+        // a control character in a string is reported before the string ends
+        json::push_parser r;
+        CHECK_THROWS_AS(r.feed("[\"a\x01"), configor_deserialization_error);
+    }
+
+    SECTION("test_interned_keys")
+    {
+        intern_table                table;
+        interned_json::push_parser p{ interned_json::parser::with_key_interning(table) };
+        CHECK_FALSE(p.feed("[{\"a long key name\": 1}, {\"a long"));
+        CHECK(p.feed(" key name\": 2}]"));
+        p.finish();
+
+        const auto& first  = p.value()[0].begin().key();
+        const auto& second = p.value()[1].begin().key();
+        CHECK(first.is_shared());
+        CHECK(first.data() == second.data());
+        CHECK(table.size() == 1);
+    }
+
+    SECTION("test_insitu_strings")
+    {
+        // in-situ strings are turned off, since each chunk is released once it is parsed
+        insitu_json::push_parser p{ insitu_json::parser::with_insitu_strings(true) };
+        CHECK_FALSE(p.feed("[\"abc\", {\"key\": \"va"));
+        CHECK(p.feed("lue\"}]"));
+        p.finish();
+
+        const auto& value = p.value();
+        CHECK_FALSE(value[0].get<const insitu_json::value::string_type&>().is_view());
+        CHECK_FALSE(value[1].begin().key().is_view());
+        CHECK_FALSE(value[1]["key"].get<const insitu_json::value::string_type&>().is_view());
+        CHECK(value == insitu_json::parse("[\"abc\", {\"key\": \"value\"}]"));
+    }
+
+    SECTION("test_sax")
+    {
+        key_collector collector;
+        collector.stop_at = "name";
+
+        json::push_parser p{ collector };
+        CHECK_FALSE(p.feed(input.substr(0, 20)));
+        CHECK(p.feed(input.substr(20)));
+        CHECK(collector.keys == "id pi name ");
+        CHECK(p.feed("garbage"));
+    }
+}
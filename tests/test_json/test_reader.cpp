@@ -0,0 +1,123 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <sstream>
+
+TEST_CASE("test_reader")
+{
+    const std::string input =
+        "{ \"id\": 12, \"skip\": { \"a\": [1, \"]}\", { \"b\": \"\\\"}\" }] /* ] */ }, \"pi\": 3.5, \"ok\": true,"
+        " \"items\": [\"x\", null, [], {}] }";
+
+    SECTION("test_next")
+    {
+        json::reader r(input);
+        CHECK(r.next() == token_type::begin_object);
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.get_string() == "id");
+        CHECK(r.next() == token_type::value_integer);
+        CHECK(r.get_integer() == 12);
+        CHECK(r.depth() == 1);
+
+        // the key is skipped without reading
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.next() == token_type::begin_object);
+        CHECK(r.depth() == 1);
+        r.skip_value();
+        CHECK(r.token() == token_type::end_object);
+
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.get_string() == "pi");
+        CHECK(r.next() == token_type::value_float);
+        CHECK(r.get_float() == 3.5);
+        CHECK_THROWS_AS(r.get_integer(), configor_deserialization_error);
+
+        CHECK(r.next() == token_type::value_string);
+        r.skip_value();
+        CHECK(r.token() == token_type::literal_true);
+
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.next() == token_type::begin_array);
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.get_string() == "x");
+        CHECK(r.next() == token_type::literal_null);
+        CHECK(r.next() == token_type::begin_array);
+        CHECK(r.next() == token_type::end_array);
+        CHECK(r.next() == token_type::begin_object);
+        CHECK(r.next() == token_type::end_object);
+        CHECK(r.next() == token_type::end_array);
+        CHECK(r.next() == token_type::end_object);
+        CHECK(r.next() == token_type::end_of_input);
+    }
+
+    SECTION("test_skip_value")
+    {
+        // contiguous input matches brackets, streams are tokenized
+        auto read_fields = [](json::reader& r)
+        {
+            CHECK(r.next() == token_type::begin_object);
+            int64_t id = 0;
+            double  pi = 0;
+            while (r.next() == token_type::value_string)
+            {
+                const auto key = r.get_string();
+                if (key == "id")
+                {
+                    r.next();
+                    id = r.get_integer();
+                }
+                else if (key == "pi")
+                {
+                    r.next();
+                    pi = r.get_float();
+                }
+                else
+                {
+                    r.skip_value();
+                }
+            }
+            CHECK(r.token() == token_type::end_object);
+            CHECK(r.next() == token_type::end_of_input);
+            CHECK(id == 12);
+            CHECK(pi == 3.5);
+        };
+
+        json::reader buffer_reader(input);
+        read_fields(buffer_reader);
+
+        std::istringstream iss(input);
+        json::reader       stream_reader(iss);
+        read_fields(stream_reader);
+
+        json::reader r("[[1, [2]], 3]");
+        CHECK(r.next() == token_type::begin_array);
+        CHECK(r.next() == token_type::begin_array);
+        r.skip_value();
+        CHECK(r.next() == token_type::value_integer);
+        CHECK(r.get_integer() == 3);
+        CHECK(r.next() == token_type::end_array);
+    }
+
+    SECTION("test_reader_error")
+    {
+        json::reader missing_colon("{\"a\" 1}");
+        CHECK(missing_colon.next() == token_type::begin_object);
+        CHECK(missing_colon.next() == token_type::value_string);
+        CHECK_THROWS_AS(missing_colon.next(), configor_deserialization_error);
+
+        json::reader missing_comma("[1 2]");
+        CHECK(missing_comma.next() == token_type::begin_array);
+        CHECK(missing_comma.next() == token_type::value_integer);
+        CHECK_THROWS_AS(missing_comma.next(), configor_deserialization_error);
+
+        json::reader unclosed("[[1, \"]\"");
+        CHECK(unclosed.next() == token_type::begin_array);
+        CHECK(unclosed.next() == token_type::begin_array);
+        CHECK_THROWS_AS(unclosed.skip_value(), configor_deserialization_error);
+
+        json::reader trailing("1 2");
+        CHECK(trailing.next() == token_type::value_integer);
+        CHECK_THROWS_AS(trailing.next(), configor_deserialization_error);
+    }
+}
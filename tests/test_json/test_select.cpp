@@ -0,0 +1,62 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <string>
+
+TEST_CASE("test_select")
+{
+    const std::string input =
+        "{ \"user\": { \"id\": 42, \"name\": \"\\u4e2d\", \"bio\": \"}\\\"]\" }, \"skip\": [1, {\"a\": \"]}\"}],"
+        " \"items\": [\"x\", { \"k\": [1, 2] }, null], \"a/b\": 1, \"m~n\": 2 }";
+
+    SECTION("test_paths")
+    {
+        const json::value j = json::parse_select(input, { "/user/id", "/items" });
+        CHECK(j.size() == 2);
+        CHECK(j["user"].size() == 1);
+        CHECK(j["user"]["id"].get<int>() == 42);
+        CHECK(j["items"] == json::parse(input)["items"]);
+        CHECK(j.count("skip") == 0);
+    }
+
+    SECTION("test_array_index")
+    {
+        const json::value j = json::parse_select(input, { "/items/1/k/1", "/skip/1" });
+        CHECK(j["items"].size() == 2);
+        CHECK(j["items"][0].is_null());
+        CHECK(j["items"][1]["k"][1].get<int>() == 2);
+        CHECK(j["skip"][1]["a"].get<std::string>() == "]}");
+    }
+
+    SECTION("test_escaped_token")
+    {
+        const json::value j = json::parse_select(input, { "/a~1b", "/m~0n" });
+        CHECK(j["a/b"].get<int>() == 1);
+        CHECK(j["m~n"].get<int>() == 2);
+        CHECK_THROWS_AS(json::parse_select(input, { "/m~2n" }), configor_invalid_key);
+        CHECK_THROWS_AS(json::parse_select(input, { "user" }), configor_invalid_key);
+    }
+
+    SECTION("test_missing_and_whole")
+    {
+        CHECK(json::parse_select(input, { "/none", "/user/none", "/items/7" }).is_null());
+        CHECK(json::parse_select(input, { "", "/user/id" }) == json::parse(input));
+        CHECK(json::parse_select(input, { "/user", "/user/id" })["user"] == json::parse(input)["user"]);
+    }
+
+    SECTION("test_duplicated_keys")
+    {
+        // the first value of a key is selected like parse keeps it, even if nothing is selected inside it
+        const std::string duplicated = "{ \"a\": { \"x\": 1 }, \"a\": { \"b\": 2 }, \"c\": 3, \"c\": 4 }";
+        CHECK(json::parse_select(duplicated, { "/a/b" }).is_null());
+        CHECK(json::parse_select(duplicated, { "/a/x" })["a"]["x"].get<int>() == 1);
+        CHECK(json::parse_select(duplicated, { "/a", "/c" }) == json::parse(duplicated));
+    }
+
+    SECTION("test_errors")
+    {
+        CHECK_THROWS_AS(json::parse_select("{\"user\": {\"id\": }}", { "/user/id" }), configor_deserialization_error);
+        CHECK_THROWS_AS(json::parse_select("[1] 2", { "/0" }), configor_deserialization_error);
+    }
+}
@@ -2,9 +2,39 @@
 
 #include "common.h"
 
-#include <cmath>    // std::acos
+#include <cmath>    // std::acos, std::isfinite
+#include <cstdio>   // std::snprintf
+#include <cstdlib>  // std::strtod
+#include <cstring>  // std::memcpy
 #include <iomanip>  // std::setw, std::fill, std::setprecision
+#include <limits>   // std::numeric_limits
 #include <sstream>  // std::stringstream
+#include <string>   // std::to_string
+
+namespace
+{
+// the count of significant digits of a dumped float
+int significant_digits(const std::string& str)
+{
+    std::string digits;
+    for (const char ch : str.substr(0, str.find('e')))
+    {
+        if (ch >= '0' && ch <= '9' && (ch != '0' || !digits.empty()))
+            digits.push_back(ch);
+    }
+    while (digits.size() > 1 && digits.back() == '0')
+        digits.pop_back();
+    return static_cast<int>(digits.size());
+}
+
+// true if d reads back exactly from its nearest decimal with the given significant digits
+bool reads_back(double d, int digits)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.*e", digits - 1, d);
+    return std::strtod(buffer, nullptr) == d;
+}
+}  // namespace
 
 class SerializerTest
 {
@@ -142,6 +172,28 @@ TEST_CASE("test_serializer")
         CHECK(wjson::dump(wjson::value(-0)) == WIDE("0"));
         CHECK(wjson::dump(wjson::value(int32_t(-2147483647))) == WIDE("-2147483647"));
         CHECK(wjson::dump(wjson::value(int64_t(-9223372036854775807))) == WIDE("-9223372036854775807"));
+
+        // every digit count and the boundaries of 32-bit values
+        int64_t power = 1;
+        for (int digits = 1; digits <= 18; ++digits, power *= 10)
+        {
+            for (const int64_t i : { power, power - 1, power * 9 + 1, -power, -(power * 10 - 1) })
+            {
+                CHECK(json::dump(json::value(i)) == std::to_string(i));
+            }
+        }
+        CHECK(json::dump(json::value(int64_t(4294967295))) == "4294967295");
+        CHECK(json::dump(json::value(int64_t(4294967296))) == "4294967296");
+        CHECK(json::dump(json::value((std::numeric_limits<int64_t>::min)())) == "-9223372036854775808");
+        CHECK(wjson::dump(wjson::value((std::numeric_limits<int64_t>::min)())) == WIDE("-9223372036854775808"));
+    }
+
+    SECTION("test_control_escapes")
+    {
+        // control characters are escaped with 4 hex digits
+        CHECK(json::dump(json::value("\x01\x1F")) == "\"\\u0001\\u001F\"");
+        CHECK(json::dump(json::value("\xC2\x80"), { json::serializer::with_unicode_escaping(true) }) == "\"\\u0080\"");
+        CHECK(wjson::dump(wjson::value(WIDE("\x01"))) == WIDE("\"\\u0001\""));
     }
 
     SECTION("test_dump_intend")
@@ -156,6 +208,44 @@ TEST_CASE("test_serializer")
         CHECK(json::dump(j, { json::serializer::with_indent(2, '$') }) == "[\n$${\n$$$$\"num\":$1\n$$},\n$$true\n]");
     }
 
+    SECTION("test_dump_with_policies")
+    {
+        json::value j;
+        j[0] = json::object({ { "num", 1.5 } });
+        j[1] = "中文";
+
+        CHECK(json::dump<json::opts::utf8>(j) == json::dump(j));
+        CHECK(json::dump<json::opts::indent<4>>(j) == json::dump(j, { json::serializer::with_indent(4) }));
+        CHECK(json::dump<json::opts::indent<2, '$'>, json::opts::unicode_escaping>(j)
+              == json::dump(j, { json::serializer::with_indent(2, '$'),
+                                 json::serializer::with_unicode_escaping(true) }));
+        CHECK(json::dump<json::opts::precision<3>>(j) == "[{\"num\":1.500},\"中文\"]");
+
+        // the width and fill of the stream are the indent unless an indent is given, like the serializer options
+        std::stringstream ss;
+        ss << std::setw(2) << std::setfill('$');
+        json::dump<json::opts::max_depth<2>>(ss, j);
+        CHECK(ss.str() == json::dump(j, { json::serializer::with_indent(2, '$') }));
+
+        std::stringstream indented_ss;
+        indented_ss << std::setw(2);
+        json::dump<json::opts::indent<4>>(indented_ss, j);
+        CHECK(indented_ss.str() == json::dump(j, { json::serializer::with_indent(4) }));
+
+        std::stringstream compact_ss;
+        compact_ss << std::setw(2);
+        json::dump<json::opts::indent<0>>(compact_ss, j);
+        CHECK(compact_ss.str() == json::dump(j));
+
+        // character types are still accepted as the only template argument
+        CHECK(json::dump<char>(j) == json::dump(j));
+        CHECK(json::dump<wchar_t>(j) == L"[{\"num\":1.5},\"中文\"]");
+
+        std::stringstream css;
+        json::dump<char>(css, j);
+        CHECK(css.str() == json::dump(j));
+    }
+
     SECTION("test_dump_minimal_float")
     {
         // issue 11
@@ -163,14 +253,58 @@ TEST_CASE("test_serializer")
         const double minimal_float = pi / 1000000.0;
 
         json::value j = minimal_float;
-        CHECK(json::dump(j) == "3.14159e-06");
+        CHECK(json::dump(j) == "3.1415926535897933e-06");
         CHECK(json::dump(j, { json::serializer::with_precision(6, std::ios_base::fmtflags{}) }) == "3.14159e-06");
         CHECK(json::dump(j, { json::serializer::with_precision(std::numeric_limits<double>::digits10 + 1,
                                                                std::ios_base::fmtflags{}) })
               == "3.141592653589793e-06");
 
         j = json::parse(json::dump(j));
-        CHECK(j.get<double>() == Approx(minimal_float));
+        CHECK(j.get<double>() == minimal_float);
+    }
+
+    SECTION("test_dump_shortest_float")
+    {
+        CHECK(json::dump(json::value(0.1)) == "0.1");
+        CHECK(json::dump(json::value(1.0)) == "1.0");
+        CHECK(json::dump(json::value(-2.5)) == "-2.5");
+        CHECK(json::dump(json::value(0.0)) == "0.0");
+        CHECK(json::dump(json::value(-0.0)) == "-0.0");
+        CHECK(json::dump(json::value(100.0)) == "100.0");
+        CHECK(json::dump(json::value(123456.789)) == "123456.789");
+        CHECK(json::dump(json::value(0.001)) == "0.001");
+        CHECK(json::dump(json::value(1e-5)) == "1e-05");
+        CHECK(json::dump(json::value(1.5e300)) == "1.5e+300");
+        CHECK(json::dump(json::value(1e14)) == "100000000000000.0");
+        CHECK(json::dump(json::value(1e15)) == "1000000000000000.0");
+        CHECK(json::dump(json::value(1e16)) == "1e+16");
+        CHECK(json::dump(json::value(1e23)) == "1e+23");
+        CHECK(json::dump(json::value(5e-324)) == "5e-324");
+        CHECK(json::dump(json::value(9.3e18)) == "9.3e+18");
+        CHECK(json::dump(json::value((std::numeric_limits<double>::max)())) == "1.7976931348623157e+308");
+        CHECK(wjson::dump(wjson::value(0.1)) == WIDE("0.1"));
+
+        // every value reads back exactly, and no fewer digits do
+        uint64_t bits = 0x9E3779B97F4A7C15;
+        for (int i = 0; i < 10000; ++i)
+        {
+            bits ^= bits << 13;
+            bits ^= bits >> 7;
+            bits ^= bits << 17;
+
+            double d = 0;
+            std::memcpy(&d, &bits, sizeof(d));
+            if (!std::isfinite(d))
+                continue;
+
+            const std::string str = json::dump(json::value(d));
+            CHECK(json::parse(str).get<double>() == d);
+
+            const int digits = significant_digits(str);
+            CHECK((digits == 1 || !reads_back(d, digits - 1)));
+        }
+        CHECK(json::parse(json::dump(json::value((std::numeric_limits<double>::denorm_min)()))).get<double>()
+              == (std::numeric_limits<double>::denorm_min)());
     }
 
     SECTION("test_float_precision")
@@ -187,6 +321,18 @@ TEST_CASE("test_serializer")
         ss.str("");
         ss << std::fixed << std::setprecision(12) << json::wrap(j);
         CHECK(ss.str() == "3.141592653590");
+
+        // a precision of 6 on the stream is the default, which is only used without the shortest representation
+        ss.str("");
+        ss << std::defaultfloat << std::setprecision(6) << json::wrap(j);
+        CHECK(ss.str() == "3.141592653589793");
+
+        ss.str("");
+        json::dump(ss, j, { json::serializer::with_shortest_float(false) });
+        CHECK(ss.str() == "3.14159");
+        CHECK(json::dump<json::opts::shortest_float<false>>(j) == "3.14159");
+        CHECK(json::dump(j, { json::serializer::with_precision(4), json::serializer::with_shortest_float(true) })
+              == "3.141592653589793");
     }
 
     SECTION("test_wrap")
@@ -203,3 +349,82 @@ TEST_CASE("test_serializer")
         CHECK(i2 == i);
     }
 }
+
+namespace
+{
+// a serializer implemented with the virtual functions of basic_serializer
+class token_serializer : public configor::detail::basic_serializer<json::value, char>
+{
+public:
+    explicit token_serializer(std::ostream& os)
+        : basic_serializer(os)
+        , values(0)
+    {
+    }
+
+    int values;
+
+protected:
+    virtual void next(configor::token_type t) override
+    {
+        if (t != configor::token_type::end_of_input)
+            os_ << to_string(t) << ' ';
+    }
+
+    virtual void put_integer(json::value::integer_type i) override
+    {
+        os_ << i << ' ';
+    }
+
+    virtual void put_float(json::value::float_type f) override
+    {
+        os_ << f << ' ';
+    }
+
+    virtual void put_string(const json::value::string_type& s) override
+    {
+        os_ << s << ' ';
+    }
+
+    virtual void do_dump(const json::value& c) override
+    {
+        ++values;
+        basic_serializer::do_dump(c);
+    }
+};
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+
+    CONFIGOR_BIND(json::value, Point, REQUIRED(x), REQUIRED(y));
+};
+}  // namespace
+
+TEST_CASE("test_virtual_serializer")
+{
+    std::stringstream ss;
+    token_serializer  s{ ss };
+    s.set_source_encoding<configor::encoding::utf8>();
+    s.set_target_encoding<configor::encoding::utf8>();
+    s.dump(json::array{ 1, "a", json::object{ { "k", true } } });
+
+    CHECK(ss.str()
+          == "begin_array value_integer 1 value_separator value_string a value_separator begin_object value_string k "
+             "name_separator literal_true end_object end_array ");
+    CHECK(s.values == 5);
+
+    // the keys of a bound type are written by put_string too
+    std::stringstream bound_ss;
+    token_serializer  bound{ bound_ss };
+    bound.set_source_encoding<configor::encoding::utf8>();
+    bound.set_target_encoding<configor::encoding::utf8>();
+    Point p;
+    p.x = 1;
+    p.y = 2;
+    bound.dump_bound(p);
+    CHECK(bound_ss.str()
+          == "begin_object value_string x name_separator value_integer 1 value_separator value_string y "
+             "name_separator value_integer 2 end_object ");
+}
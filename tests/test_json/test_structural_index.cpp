@@ -0,0 +1,111 @@
+// Copyright (c) 2019 Nomango
+
+#include "common.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::size_t> offsets(const json::structural_index& index)
+{
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < index.size(); ++i)
+        result.push_back(static_cast<std::size_t>(index[i] - index.begin_of_input()));
+    return result;
+}
+
+// returns the error message, or the dumped value
+std::string parse_both(const std::string& input, bool indexed)
+{
+    try
+    {
+        if (indexed)
+            return json::dump(json::parse(input, { json::parser::with_structural_index() }));
+        return json::dump(json::parse(input));
+    }
+    catch (const configor_deserialization_error&)
+    {
+        return "error";
+    }
+}
+}  // namespace
+
+TEST_CASE("test_structural_index")
+{
+    SECTION("test_build")
+    {
+        const std::string input = "{\"a\": [1, \"x\\\"y\", true], \"b\":-2.5}";
+
+        json::structural_index index(input.data(), input.data() + input.size());
+        CHECK(index.valid());
+        CHECK(offsets(index) == std::vector<std::size_t>{ 0, 1, 4, 6, 7, 8, 10, 16, 18, 22, 23, 25, 28, 29, 33 });
+        CHECK(index.find_close(0) == 14);
+        CHECK(index.find_close(3) == 9);
+
+        // backslashes across a block boundary
+        for (std::size_t i = 55; i < 70; ++i)
+        {
+            const std::string pad(i, ' ');
+            for (const char* str : { "\"\\\\\"", "\"\\\\\\\"\"", "\"a\\\\\\\\\"" })
+            {
+                const std::string doc = pad + "[" + str + ",1]";
+                json::structural_index idx(doc.data(), doc.data() + doc.size());
+                CHECK(idx.valid());
+                CHECK(idx.size() == 5);
+                CHECK(json::parse(doc, { json::parser::with_structural_index(idx) }) == json::parse(doc));
+            }
+        }
+
+        // left to the regular parser
+        const std::string comment = "[1, /* ] */ 2]";
+        CHECK_FALSE(json::structural_index(comment.data(), comment.data() + comment.size()).valid());
+        CHECK(json::parse(comment, { json::parser::with_structural_index() }) == json::array{ 1, 2 });
+
+        const std::string unterminated = "[\"abc]";
+        CHECK_FALSE(json::structural_index(unterminated.data(), unterminated.data() + unterminated.size()).valid());
+    }
+
+    SECTION("test_parse_indexed")
+    {
+        const std::string input =
+            " { \"id\": 12, \"skip\": { \"a\": [1, \"]}\", { \"b\": \"\\\"}\" }] }, \"pi\": 3.5, \"ok\": true,\n"
+            "\t\"name\": \"\\u4e2d\\u6587\", \"items\": [\"x\", null, [], {}, -0, 1e5, false,] } ";
+        CHECK(json::parse(input, { json::parser::with_structural_index() }) == json::parse(input));
+
+        const std::vector<std::string> invalid = { "1x",    "[1 2]", "truefalse", "[1]]",  "{\"a\" 1}", "[\"a\"\"b\"]",
+                                                   "\\\"a", "[-]",   "nul",       "[1,,]", "{]",        "[1] 2" };
+        for (const auto& str : invalid)
+            CHECK_THROWS_AS(json::parse(str, { json::parser::with_structural_index() }),
+                            configor_deserialization_error);
+
+        // the reader skips with the index
+        json::reader r(input.data(), input.size(), { json::parser::with_structural_index() });
+        CHECK(r.next() == token_type::begin_object);
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.next() == token_type::value_integer);
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.next() == token_type::begin_object);
+        r.skip_value();
+        CHECK(r.next() == token_type::value_string);
+        CHECK(r.get_string() == "pi");
+    }
+
+    SECTION("test_parse_mutated")
+    {
+        const std::string input =
+            "{\"id\": 12, \"list\": [1, -2.5e3, \"a\\\\b\\\"c\", true, null, {\"k\": [false, {}]}],"
+            " \"s\": \"\\u4e2d\"}";
+
+        std::mt19937 rng(42);
+        const char   replacements[] = "{}[],:\"\\ /0a-e";
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string doc = input;
+            for (int n = 0; n < 2; ++n)
+                doc[rng() % doc.size()] = replacements[rng() % (sizeof(replacements) - 1)];
+            CHECK(parse_both(doc, true) == parse_both(doc, false));
+        }
+    }
+}
@@ -3,6 +3,21 @@
 #include "common.h"
 
 #include <sstream>  // std::wstringstream
+#include <string>   // std::string
+
+template <typename _CharTy>
+struct stream_only_utf8
+{
+    static void encode(std::basic_ostream<_CharTy>& os, uint32_t codepoint)
+    {
+        encoding::utf8<_CharTy>::encode(os, codepoint);
+    }
+
+    static bool decode(std::basic_istream<_CharTy>& is, uint32_t& codepoint)
+    {
+        return encoding::utf8<_CharTy>::decode(is, codepoint);
+    }
+};
 
 TEST_CASE("test_unicode")
 {
@@ -32,6 +47,53 @@ TEST_CASE("test_unicode")
         }
     }
 
+    SECTION("test_stream_only_encoding")
+    {
+        // an encoding without buffer decoding is read through a stream
+        json::value j;
+        CHECK_NOTHROW(j = json::parse(QUOTE_STR, { json::parser::with_encoding<stream_only_utf8>() }));
+        CHECK(j.get<std::string>() == RAW_STR);
+    }
+
+    SECTION("test_dump_utf8_copy")
+    {
+        // runs copied from UTF-8 to UTF-8 are the same as the codepoints encoded one by one
+        const std::string pieces[] = {
+            "a",    "\"",   "\\",       "\n",       "\x01",         "\x7F",     "\xC3\xA9", "中", "😀",
+            "\xFF", "\xC2", "\xC0\x80", "\xC2\x41", "\xED\xA0\x80", "\xF4\x90", "abcd",     "/",
+        };
+        const std::size_t count = sizeof(pieces) / sizeof(pieces[0]);
+
+        uint32_t seed = 1;
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string str;
+            for (int n = i % 50; n > 0; --n)
+            {
+                seed = seed * 1103515245 + 12345;
+                str += ((seed >> 16) % 4 == 0) ? pieces[(seed >> 8) % count] : std::string(1 + (seed >> 20) % 20, 'x');
+            }
+
+            const json::value j = str;
+
+            std::string expect;
+            bool        expect_error = false;
+            try
+            {
+                expect = json::dump(j, { json::serializer::with_encoding<stream_only_utf8>() });
+            }
+            catch (const configor_serialization_error&)
+            {
+                expect_error = true;
+            }
+
+            if (expect_error)
+                CHECK_THROWS_AS(json::dump(j), configor_serialization_error);
+            else
+                CHECK(json::dump(j) == expect);
+        }
+    }
+
     SECTION("test_parse_w")
     {
         auto j = wjson::parse(L"{ \"happy\": true, \"pi\": 3.141, \"name\": \"中文测试\" }");